@@ -0,0 +1,142 @@
+#ifndef ALLOCATION_REPORT_H
+#define ALLOCATION_REPORT_H
+
+#include <deque>
+#include <forward_list>
+#include <functional>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "counting_allocator.h"
+#include "output_sink.h"
+
+/*
+ * Allocation report for the containers demoed in main.cpp (run with --alloc-report [count]).
+ *
+ * Every container type from main() is rebuilt with CountingAllocator and filled with
+ * 'count' elements, one insert at a time. For each one we print the number of heap
+ * allocations, allocations per insert, total bytes allocated, live and peak bytes,
+ * and how many bytes each element really costs compared to sizeof(value_type).
+ *
+ * std::array is left out: it never touches the heap. The std::string keys are short
+ * enough for the small string optimization, so they do not allocate either.
+ */
+
+struct AllocationRow {
+    std::string name;
+    std::size_t elements = 0;
+    std::size_t elementSize = 0;
+    AllocationStats stats;
+};
+
+// Builds a Container with a counting allocator, calls insert(container, i) for i in [0, count)
+// and returns the statistics as they were right before the container is destroyed.
+template <typename Container, typename Insert>
+AllocationRow measureAllocations(const std::string& name, std::size_t count, std::size_t elementSize, Insert insert) {
+    AllocationRow row{name, count, elementSize, {}};
+    AllocationStats stats;
+    {
+        Container container{CountingAllocator<typename Container::value_type>(stats)};
+        for (std::size_t i = 0; i < count; ++i) {
+            insert(container, static_cast<int>(i));
+        }
+        row.stats = stats;
+    }
+    return row;
+}
+
+inline std::string reportKey(int i) {
+    return "key" + std::to_string(i);
+}
+
+inline void printAllocationReport(OutputSink& out, const std::vector<AllocationRow>& rows) {
+    std::ostringstream table;
+    table << std::left << std::setw(44) << "Container" << std::right
+          << std::setw(12) << "elements" << std::setw(12) << "allocs" << std::setw(14) << "allocs/insert"
+          << std::setw(16) << "bytes total" << std::setw(16) << "bytes live" << std::setw(16) << "bytes peak"
+          << std::setw(12) << "bytes/elem" << std::setw(12) << "sizeof" << std::setw(12) << "overhead" << '\n';
+    table << std::fixed << std::setprecision(2);
+    for (const AllocationRow& row : rows) {
+        double elements = row.elements == 0 ? 1.0 : static_cast<double>(row.elements);
+        double perElement = static_cast<double>(row.stats.liveBytes) / elements;
+        table << std::left << std::setw(44) << row.name << std::right
+              << std::setw(12) << row.elements
+              << std::setw(12) << row.stats.allocations
+              << std::setw(14) << static_cast<double>(row.stats.allocations) / elements
+              << std::setw(16) << row.stats.bytesAllocated
+              << std::setw(16) << row.stats.liveBytes
+              << std::setw(16) << row.stats.peakLiveBytes
+              << std::setw(12) << perElement
+              << std::setw(12) << row.elementSize
+              << std::setw(12) << perElement - static_cast<double>(row.elementSize) << '\n';
+    }
+    out << table.str();
+}
+
+inline void runAllocationReport(OutputSink& out, std::size_t count) {
+    using StringIntPair = std::pair<const std::string, int>;
+    std::vector<AllocationRow> rows;
+
+    rows.push_back(measureAllocations<std::vector<int, CountingAllocator<int>>>(
+        "std::vector<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push_back(i); }));
+    rows.push_back(measureAllocations<std::list<int, CountingAllocator<int>>>(
+        "std::list<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push_back(i); }));
+    rows.push_back(measureAllocations<std::deque<int, CountingAllocator<int>>>(
+        "std::deque<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push_back(i); }));
+    rows.push_back(measureAllocations<std::set<int, std::less<int>, CountingAllocator<int>>>(
+        "std::set<int>", count, sizeof(int),
+        [](auto& c, int i) { c.insert(i); }));
+    rows.push_back(measureAllocations<std::multiset<int, std::less<int>, CountingAllocator<int>>>(
+        "std::multiset<int>", count, sizeof(int),
+        [](auto& c, int i) { c.insert(i); }));
+    rows.push_back(measureAllocations<std::map<std::string, int, std::less<std::string>, CountingAllocator<StringIntPair>>>(
+        "std::map<std::string, int>", count, sizeof(StringIntPair),
+        [](auto& c, int i) { c.emplace(reportKey(i), i); }));
+    rows.push_back(measureAllocations<std::multimap<std::string, int, std::less<std::string>, CountingAllocator<StringIntPair>>>(
+        "std::multimap<std::string, int>", count, sizeof(StringIntPair),
+        [](auto& c, int i) { c.emplace(reportKey(i), i); }));
+    rows.push_back(measureAllocations<std::stack<int, std::deque<int, CountingAllocator<int>>>>(
+        "std::stack<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push(i); }));
+    rows.push_back(measureAllocations<std::queue<int, std::deque<int, CountingAllocator<int>>>>(
+        "std::queue<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push(i); }));
+    rows.push_back(measureAllocations<std::priority_queue<int, std::vector<int, CountingAllocator<int>>>>(
+        "std::priority_queue<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push(i); }));
+    rows.push_back(measureAllocations<std::forward_list<int, CountingAllocator<int>>>(
+        "std::forward_list<int>", count, sizeof(int),
+        [](auto& c, int i) { c.push_front(i); }));
+    rows.push_back(measureAllocations<std::unordered_set<int, std::hash<int>, std::equal_to<int>, CountingAllocator<int>>>(
+        "std::unordered_set<int>", count, sizeof(int),
+        [](auto& c, int i) { c.insert(i); }));
+    rows.push_back(measureAllocations<std::unordered_map<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+                                                         CountingAllocator<StringIntPair>>>(
+        "std::unordered_map<std::string, int>", count, sizeof(StringIntPair),
+        [](auto& c, int i) { c.emplace(reportKey(i), i); }));
+    rows.push_back(measureAllocations<std::unordered_multimap<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+                                                              CountingAllocator<StringIntPair>>>(
+        "std::unordered_multimap<std::string, int>", count, sizeof(StringIntPair),
+        [](auto& c, int i) { c.emplace(reportKey(i), i); }));
+    rows.push_back(measureAllocations<std::unordered_multiset<int, std::hash<int>, std::equal_to<int>, CountingAllocator<int>>>(
+        "std::unordered_multiset<int>", count, sizeof(int),
+        [](auto& c, int i) { c.insert(i); }));
+
+    out << "Heap allocations for " << count << " elements per container\n";
+    printAllocationReport(out, rows);
+}
+
+#endif // ALLOCATION_REPORT_H
@@ -0,0 +1,167 @@
+#ifndef BATCH_ERASE_H
+#define BATCH_ERASE_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "swiss_table.h"
+
+/*
+ * Removing many elements from a std::vector or std::deque in one pass.
+ *
+ * The find-then-erase loop
+ *     while ((it = std::find(it, v.end(), x)) != v.end()) it = v.erase(it);
+ * shifts the whole tail once per removed element, so removing k of n elements costs
+ * O(n * k) moves. Everything here costs O(n):
+ *
+ * eraseValues        erases every element equal to one of 'values'. Small sets are
+ *                    checked by a linear scan, larger ones through a swiss_set (or a sorted
+ *                    vector, for types without std::hash).
+ * eraseAt            erases the elements at a set of positions (say, collected by find)
+ *                    with one compaction pass.
+ * unstableErase      swap-and-pop: moves the last element into the erased slot and pops
+ *                    the back. O(1), but the order of the remaining elements changes.
+ * unstableEraseIf    the same for every element matching a predicate: matches at the
+ *                    front are filled from non-matches at the back, so only about as many
+ *                    elements move as are removed, instead of the whole tail.
+ * unstableEraseValues  unstableEraseIf with the value lookup of eraseValues.
+ *
+ * For a plain predicate, the stable batch erase is std::erase_if (C++20).
+ * All functions return the number of elements removed.
+ */
+
+// eraseValues / unstableEraseValues check up to this many values with a linear scan.
+inline constexpr std::size_t eraseValuesLinearMax = 8;
+
+namespace erase_detail {
+
+template <typename T>
+concept Hashable = requires(const T& value) {
+    { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+};
+
+// Calls 'body' with a predicate telling whether an element is one of 'values'.
+template <typename T, typename Body>
+decltype(auto) withValueLookup(std::span<const T> values, Body&& body) {
+    if (values.size() <= eraseValuesLinearMax) {
+        return body([values](const T& element) {
+            return std::find(values.begin(), values.end(), element) != values.end();
+        });
+    } else if constexpr (Hashable<T>) {
+        swiss_set<T> lookup(values.begin(), values.end());
+        return body([&lookup](const T& element) { return lookup.contains(element); });
+    } else {
+        std::vector<T> lookup(values.begin(), values.end());
+        std::sort(lookup.begin(), lookup.end());
+        return body([&lookup](const T& element) {
+            return std::binary_search(lookup.begin(), lookup.end(), element);
+        });
+    }
+}
+
+} // namespace erase_detail
+
+// Erases the element at 'position' by moving the last element into its place.
+// Returns an iterator to the element now at that position (end() if it was the last one).
+template <typename Container>
+typename Container::iterator unstableErase(Container& container, typename Container::iterator position) {
+    auto index = position - container.begin();
+    if (position != std::prev(container.end())) {
+        *position = std::move(container.back());
+    }
+    container.pop_back();
+    return container.begin() + index;
+}
+
+// Erases every element matching 'pred'; the order of the remaining elements is not kept.
+template <typename Container, typename Predicate>
+std::size_t unstableEraseIf(Container& container, Predicate pred) {
+    auto first = container.begin();
+    auto last = container.end();
+    for (;;) {
+        first = std::find_if(first, last, pred);
+        if (first == last) {
+            break;
+        }
+        // The last element that stays moves into the hole; matches passed on the way are dropped.
+        do {
+            --last;
+        } while (last != first && pred(*last));
+        if (last == first) {
+            break;
+        }
+        *first = std::move(*last);
+        ++first;
+    }
+    auto removed = static_cast<std::size_t>(container.end() - last);
+    container.erase(last, container.end());
+    return removed;
+}
+
+// Erases every element equal to one of 'values', keeping the order of the rest.
+template <typename Container>
+std::size_t eraseValues(Container& container, std::span<const typename Container::value_type> values) {
+    return erase_detail::withValueLookup(values, [&](auto isErased) {
+        auto kept = std::remove_if(container.begin(), container.end(), isErased);
+        auto removed = static_cast<std::size_t>(container.end() - kept);
+        container.erase(kept, container.end());
+        return removed;
+    });
+}
+
+template <typename Container>
+std::size_t eraseValues(Container& container, std::initializer_list<typename Container::value_type> values) {
+    return eraseValues(container, std::span<const typename Container::value_type>(values.begin(), values.size()));
+}
+
+// Erases every element equal to one of 'values'; the order of the remaining elements is not kept.
+template <typename Container>
+std::size_t unstableEraseValues(Container& container, std::span<const typename Container::value_type> values) {
+    return erase_detail::withValueLookup(values, [&](auto isErased) {
+        return unstableEraseIf(container, isErased);
+    });
+}
+
+template <typename Container>
+std::size_t unstableEraseValues(Container& container, std::initializer_list<typename Container::value_type> values) {
+    return unstableEraseValues(container, std::span<const typename Container::value_type>(values.begin(), values.size()));
+}
+
+// Erases the elements at 'positions' (in any order, duplicates allowed, out of range ignored),
+// keeping the order of the rest.
+template <typename Container>
+std::size_t eraseAt(Container& container, std::span<const std::size_t> positions) {
+    std::vector<std::size_t> sorted(positions.begin(), positions.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), container.size()), sorted.end());
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    // Shift each run of kept elements left over the gaps in front of it.
+    auto out = container.begin() + static_cast<std::ptrdiff_t>(sorted.front());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        auto runBegin = container.begin() + static_cast<std::ptrdiff_t>(sorted[i] + 1);
+        auto runEnd = i + 1 < sorted.size() ? container.begin() + static_cast<std::ptrdiff_t>(sorted[i + 1])
+                                            : container.end();
+        out = std::move(runBegin, runEnd, out);
+    }
+    container.erase(out, container.end());
+    return sorted.size();
+}
+
+template <typename Container>
+std::size_t eraseAt(Container& container, std::initializer_list<std::size_t> positions) {
+    return eraseAt(container, std::span<const std::size_t>(positions.begin(), positions.size()));
+}
+
+#endif // BATCH_ERASE_H
@@ -0,0 +1,74 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Small helpers shared by the benchmark programs.
+
+using BenchClock = std::chrono::steady_clock;
+
+// Seconds elapsed since 'start'.
+inline double secondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Keeps the optimizer from throwing away a value we computed only to measure it.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Reads an element count from argv[index], falling back to 'fallback'.
+inline std::size_t sizeArgument(int argc, char* argv[], int index, std::size_t fallback) {
+    if (argc > index) {
+        return static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10));
+    }
+    return fallback;
+}
+
+// Summary of a set of samples (e.g. nanoseconds per operation, one value per sample).
+struct SampleStats {
+    double mean = 0;
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+// Nearest-rank percentile of already sorted samples, 'p' in [0, 100].
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+inline SampleStats summarize(std::vector<double> samples) {
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    stats.mean = total / static_cast<double>(samples.size());
+    stats.min = samples.front();
+    stats.p50 = percentile(samples, 50);
+    stats.p90 = percentile(samples, 90);
+    stats.p99 = percentile(samples, 99);
+    stats.max = samples.back();
+    return stats;
+}
+
+#endif // BENCH_UTIL_H
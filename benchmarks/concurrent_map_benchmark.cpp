@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "concurrent_map.h"
+
+/*
+ * Threads reading and writing one std::string -> int map at the same time:
+ * std::unordered_map behind one std::mutex, behind one std::shared_mutex (readers share
+ * it), and ConcurrentHashMap from concurrent_map.h.
+ *
+ * The map starts with 'keys' keys. Every thread then runs its share of 'operations'
+ * random operations: a lookup with probability 'read ratio', otherwise an overwrite of
+ * an existing key. Each row is millions of operations per second, best of three runs,
+ * for 1, 2, 4, ... 'max threads' threads and read ratios of 50%, 90% and 99%.
+ *
+ * Usage: concurrent_map_benchmark [keys, default 100000] [operations, default 4000000]
+ *                                 [max threads, default 16]
+ */
+
+// std::unordered_map with one lock of type Mutex: shared for reads when Mutex allows it.
+template <typename Mutex>
+class LockedMap {
+public:
+    void insertOrAssign(const std::string& key, int value) {
+        std::unique_lock lock(mutex_);
+        map_[key] = value;
+    }
+
+    bool find(const std::string& key, int& out) const {
+        auto read = [&] {
+            auto it = map_.find(key);
+            if (it == map_.end()) {
+                return false;
+            }
+            out = it->second;
+            return true;
+        };
+        if constexpr (std::is_same_v<Mutex, std::shared_mutex>) {
+            std::shared_lock lock(mutex_);
+            return read();
+        } else {
+            std::unique_lock lock(mutex_);
+            return read();
+        }
+    }
+
+private:
+    mutable Mutex mutex_;
+    std::unordered_map<std::string, int> map_;
+};
+
+// Same interface over ConcurrentHashMap.
+class ShardedMap {
+public:
+    void insertOrAssign(const std::string& key, int value) { map_.insertOrAssign(key, value); }
+
+    bool find(const std::string& key, int& out) const {
+        return map_.visit(key, [&](int value) { out = value; });
+    }
+
+private:
+    ConcurrentHashMap<std::string, int> map_;
+};
+
+template <typename Map>
+double millionsPerSecond(const std::vector<std::string>& keys, std::size_t operations, std::size_t threadCount,
+                         double readRatio) {
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.insertOrAssign(keys[i], static_cast<int>(i));
+    }
+    auto readThreshold = static_cast<std::uint64_t>(readRatio * 1024);
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        std::vector<std::uint64_t> found(threadCount);
+        std::vector<std::thread> threads;
+        auto start = BenchClock::now();
+        for (std::size_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                std::mt19937_64 random(t * 7919 + static_cast<std::uint64_t>(r));
+                std::uint64_t hits = 0;
+                for (std::size_t i = t; i < operations; i += threadCount) {
+                    std::uint64_t bits = random();
+                    const std::string& key = keys[(bits >> 10) % keys.size()];
+                    if ((bits & 1023) < readThreshold) {
+                        int value;
+                        hits += map.find(key, value);
+                    } else {
+                        map.insertOrAssign(key, static_cast<int>(i));
+                    }
+                }
+                found[t] = hits;
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        best = std::min(best, secondsSince(start));
+        std::uint64_t hits = 0;
+        for (std::uint64_t count : found) {
+            hits += count;
+        }
+        doNotOptimize(hits);
+    }
+    return static_cast<double>(operations) / best / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t keyCount = std::max<std::size_t>(1, sizeArgument(argc, argv, 1, 100'000));
+    std::size_t operations = sizeArgument(argc, argv, 2, 4'000'000);
+    std::size_t maxThreads = std::max<std::size_t>(1, sizeArgument(argc, argv, 3, 16));
+    std::vector<std::string> keys;
+    keys.reserve(keyCount);
+    for (std::size_t i = 0; i < keyCount; ++i) {
+        keys.push_back("user-" + std::to_string(i * 2654435761u % 1'000'000'007u));
+    }
+    std::cout << keyCount << " keys, " << operations << " operations, " << std::thread::hardware_concurrency()
+              << " hardware threads, M operations/s" << std::endl;
+
+    for (double readRatio : {0.5, 0.9, 0.99}) {
+        std::cout << std::endl << readRatio * 100 << "% reads" << std::endl;
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            std::cout << "  " << threads << " thread(s): mutex + unordered_map "
+                      << millionsPerSecond<LockedMap<std::mutex>>(keys, operations, threads, readRatio)
+                      << ", shared_mutex + unordered_map "
+                      << millionsPerSecond<LockedMap<std::shared_mutex>>(keys, operations, threads, readRatio)
+                      << ", ConcurrentHashMap " << millionsPerSecond<ShardedMap>(keys, operations, threads, readRatio)
+                      << std::endl;
+        }
+    }
+    return 0;
+}
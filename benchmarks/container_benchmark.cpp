@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <forward_list>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_util.h"
+
+/*
+ * Puts numbers on the "Use X when..." advice printed by main.cpp.
+ *
+ * For every container demoed in main() (with int keys and values so all of them
+ * get the same data) and for every element count 10, 100, ... up to --max, this
+ * measures the operations the container supports:
+ *
+ *   insert         build the container with n push_back/push_front/insert/push calls
+ *   find           look up random existing values (std::find for sequences, find() for sets and maps)
+ *   erase          find and erase random existing values (pop for stack, queue and priority_queue)
+ *   iterate        one pass over all elements
+ *   random_access  read the element at a random position (std::next for lists)
+ *
+ * Every (container, operation, size) point is sampled several times and reported as
+ * ns/op percentiles plus throughput, as JSON on stdout (progress goes to stderr).
+ *
+ * Usage: container_benchmark [--min N] [--max N] [--only vector,map,...] [--output file.json]
+ *
+ * The default sweep goes up to 100M elements, which needs a lot of time and memory for
+ * the node-based containers; use --max to stop earlier.
+ */
+
+// Upper bounds on the work done per sample, so that small sizes are repeated often
+// enough to be measurable and O(n) operations on huge sizes still finish.
+constexpr std::size_t maxProbes = 100'000;
+constexpr std::size_t linearBudget = 10'000'000;   // element visits per sample for O(n) operations
+constexpr std::size_t buildBudget = 100'000;       // elements inserted per sample
+constexpr std::size_t iterateBudget = 1'000'000;   // elements visited per sample
+
+struct Result {
+    std::string container;
+    std::string operation;
+    std::size_t count;
+    std::size_t opsPerSample;
+    std::size_t samples;
+    SampleStats nsPerOp;
+};
+
+struct Workload {
+    std::size_t count = 0;
+    std::vector<int> values;          // 0 .. count-1 in random order
+    std::vector<std::size_t> probes;  // random positions in [0, count)
+};
+
+Workload makeWorkload(std::size_t count) {
+    Workload workload;
+    workload.count = count;
+    workload.values.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workload.values[i] = static_cast<int>(i);
+    }
+    std::mt19937_64 random(42);
+    std::shuffle(workload.values.begin(), workload.values.end(), random);
+    std::uniform_int_distribution<std::size_t> position(0, count - 1);
+    workload.probes.resize(maxProbes);
+    for (auto& probe : workload.probes) {
+        probe = position(random);
+    }
+    return workload;
+}
+
+std::size_t samplesFor(std::size_t count) {
+    if (count <= 100'000) {
+        return 15;
+    }
+    return count <= 10'000'000 ? 7 : 3;
+}
+
+template <typename C>
+concept Adaptor = requires { typename C::container_type; };
+
+template <typename C>
+concept Associative = requires { typename C::key_type; };
+
+template <typename C>
+concept MapLike = requires { typename C::mapped_type; };
+
+template <typename C>
+concept RandomAccess = !Adaptor<C> && std::random_access_iterator<typename C::const_iterator>;
+
+// O(n) lookups: sequences have to be searched front to back.
+template <typename C>
+constexpr bool linearSearch = !Associative<C>;
+
+template <typename C>
+void insertValue(C& container, int value) {
+    if constexpr (MapLike<C>) {
+        container.emplace(value, value);
+    } else if constexpr (Associative<C>) {
+        container.insert(value);
+    } else if constexpr (Adaptor<C>) {
+        container.push(value);
+    } else if constexpr (requires { container.push_back(value); }) {
+        container.push_back(value);
+    } else {
+        container.push_front(value);
+    }
+}
+
+template <typename C>
+C build(const Workload& workload) {
+    C container;
+    for (int value : workload.values) {
+        insertValue(container, value);
+    }
+    return container;
+}
+
+template <typename Element>
+int valueOf(const Element& element) {
+    if constexpr (requires { element.second; }) {
+        return element.second;
+    } else {
+        return element;
+    }
+}
+
+template <typename C>
+bool contains(const C& container, int value) {
+    if constexpr (Associative<C>) {
+        return container.find(value) != container.end();
+    } else {
+        return std::find(container.begin(), container.end(), value) != container.end();
+    }
+}
+
+template <typename C>
+void eraseValue(C& container, int value) {
+    if constexpr (Associative<C>) {
+        container.erase(value);
+    } else if constexpr (requires { container.erase_after(container.before_begin()); }) {
+        // forward_list: walk with a trailing iterator, erase_after needs the node before the match.
+        auto before = container.before_begin();
+        for (auto iter = container.begin(); iter != container.end(); before = iter++) {
+            if (*iter == value) {
+                container.erase_after(before);
+                return;
+            }
+        }
+    } else {
+        auto iter = std::find(container.begin(), container.end(), value);
+        if (iter != container.end()) {
+            container.erase(iter);
+        }
+    }
+}
+
+class Benchmark {
+public:
+    Benchmark(std::vector<Result>& results, std::string container, const Workload& workload)
+        : results_(results), container_(std::move(container)), workload_(workload), samples_(samplesFor(workload.count)) {}
+
+    // Runs 'samples' samples: 'prepare' builds the state outside the timed region,
+    // 'run' is timed and performs 'ops' operations on it.
+    template <typename Prepare, typename Run>
+    void measure(const std::string& operation, std::size_t ops, Prepare prepare, Run run) {
+        std::cerr << "  " << container_ << " " << operation << " n=" << workload_.count << std::endl;
+        std::vector<double> nsPerOp;
+        for (std::size_t sample = 0; sample < samples_; ++sample) {
+            auto state = prepare();
+            auto start = BenchClock::now();
+            run(state);
+            nsPerOp.push_back(secondsSince(start) * 1e9 / static_cast<double>(ops));
+        }
+        results_.push_back({container_, operation, workload_.count, ops, samples_, summarize(nsPerOp)});
+    }
+
+private:
+    std::vector<Result>& results_;
+    std::string container_;
+    const Workload& workload_;
+    std::size_t samples_;
+};
+
+struct NoState {};
+
+auto noState = [] { return NoState{}; };
+
+template <typename C>
+void benchFind(Benchmark& bench, const C& container, const Workload& workload) {
+    std::size_t lookups = linearSearch<C> ? std::clamp<std::size_t>(linearBudget / workload.count, 1, maxProbes) : maxProbes;
+    bench.measure("find", lookups, noState, [&](NoState&) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            hits += contains(container, workload.values[workload.probes[i]]);
+        }
+        doNotOptimize(hits);
+    });
+}
+
+template <typename C>
+void benchIterate(Benchmark& bench, const C& container, const Workload& workload) {
+    std::size_t passes = std::max<std::size_t>(1, iterateBudget / workload.count);
+    bench.measure("iterate", passes * workload.count, noState, [&](NoState&) {
+        long long sum = 0;
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            for (const auto& element : container) {
+                sum += valueOf(element);
+            }
+            doNotOptimize(sum);
+        }
+    });
+}
+
+template <typename C>
+void benchRandomAccess(Benchmark& bench, const C& container, const Workload& workload) {
+    if constexpr (RandomAccess<C>) {
+        bench.measure("random_access", maxProbes, noState, [&](NoState&) {
+            long long sum = 0;
+            for (std::size_t i = 0; i < maxProbes; ++i) {
+                sum += container[workload.probes[i]];
+            }
+            doNotOptimize(sum);
+        });
+    } else {
+        std::size_t reads = std::clamp<std::size_t>(linearBudget / workload.count, 1, maxProbes);
+        bench.measure("random_access", reads, noState, [&](NoState&) {
+            long long sum = 0;
+            for (std::size_t i = 0; i < reads; ++i) {
+                sum += *std::next(container.begin(), static_cast<std::ptrdiff_t>(workload.probes[i]));
+            }
+            doNotOptimize(sum);
+        });
+    }
+}
+
+template <typename C>
+void benchContainer(std::vector<Result>& results, const std::string& name, const Workload& workload) {
+    Benchmark bench(results, name, workload);
+    std::size_t n = workload.count;
+
+    std::size_t builds = std::max<std::size_t>(1, buildBudget / n);
+    bench.measure("insert", builds * n, [&] { return std::vector<C>(builds); }, [&](std::vector<C>& fresh) {
+        for (C& container : fresh) {
+            for (int value : workload.values) {
+                insertValue(container, value);
+            }
+        }
+    });
+
+    const C container = build<C>(workload);
+
+    // Each sample erases from its own copies, made outside the timed region.
+    std::size_t copies = std::max<std::size_t>(1, buildBudget / n);
+    std::size_t erases = Adaptor<C> ? n
+                       : linearSearch<C> ? std::clamp<std::size_t>(linearBudget / (n * copies), 1, n)
+                       : std::min(n, maxProbes);
+    bench.measure("erase", copies * erases, [&] { return std::vector<C>(copies, container); }, [&](std::vector<C>& copy) {
+        for (C& target : copy) {
+            if constexpr (Adaptor<C>) {
+                long long sum = 0;
+                while (!target.empty()) {
+                    if constexpr (requires { target.front(); }) {
+                        sum += target.front();
+                    } else {
+                        sum += target.top();
+                    }
+                    target.pop();
+                }
+                doNotOptimize(sum);
+            } else {
+                for (std::size_t i = 0; i < erases; ++i) {
+                    eraseValue(target, workload.values[i]);
+                }
+            }
+        }
+    });
+
+    if constexpr (!Adaptor<C>) {
+        benchFind(bench, container, workload);
+        benchIterate(bench, container, workload);
+        if constexpr (!Associative<C>) {
+            benchRandomAccess(bench, container, workload);
+        }
+    }
+}
+
+// std::array has its size fixed at compile time, so it only takes part at the sizes below.
+template <std::size_t N>
+void benchArray(std::vector<Result>& results, const Workload& workload) {
+    if (workload.count != N) {
+        return;
+    }
+    auto container = std::make_unique<std::array<int, N>>();
+    std::copy(workload.values.begin(), workload.values.end(), container->begin());
+    Benchmark bench(results, "std::array<int, N>", workload);
+    benchFind(bench, *container, workload);
+    benchIterate(bench, *container, workload);
+    benchRandomAccess(bench, *container, workload);
+}
+
+template <std::size_t... Sizes>
+void benchArrays(std::vector<Result>& results, const Workload& workload, std::index_sequence<Sizes...>) {
+    (benchArray<Sizes>(results, workload), ...);
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n  \"benchmark\": \"container_benchmark\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        const SampleStats& ns = result.nsPerOp;
+        out << "    {\"container\": \"" << result.container << "\", \"operation\": \"" << result.operation
+            << "\", \"size\": " << result.count << ", \"ops_per_sample\": " << result.opsPerSample
+            << ", \"samples\": " << result.samples
+            << ", \"ns_per_op\": {\"mean\": " << ns.mean << ", \"min\": " << ns.min << ", \"p50\": " << ns.p50
+            << ", \"p90\": " << ns.p90 << ", \"p99\": " << ns.p99 << ", \"max\": " << ns.max << "}"
+            << ", \"throughput_ops_per_sec\": " << (ns.mean > 0 ? 1e9 / ns.mean : 0) << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t minCount = 10;
+    std::size_t maxCount = 100'000'000;
+    std::set<std::string> only;
+    std::string output;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--min") {
+            minCount = std::stoull(value);
+        } else if (option == "--max") {
+            maxCount = std::stoull(value);
+        } else if (option == "--only") {
+            std::stringstream names(value);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                only.insert(name);
+            }
+        } else if (option == "--output") {
+            output = value;
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    auto wanted = [&](const std::string& name) {
+        return only.empty() || only.count(name) > 0;
+    };
+
+    for (std::size_t n = 10; n <= maxCount; n *= 10) {
+        if (n < minCount) {
+            continue;
+        }
+        std::cerr << "n = " << n << std::endl;
+        Workload workload = makeWorkload(n);
+
+        if (wanted("vector")) benchContainer<std::vector<int>>(results, "std::vector<int>", workload);
+        if (wanted("list")) benchContainer<std::list<int>>(results, "std::list<int>", workload);
+        if (wanted("deque")) benchContainer<std::deque<int>>(results, "std::deque<int>", workload);
+        if (wanted("set")) benchContainer<std::set<int>>(results, "std::set<int>", workload);
+        if (wanted("multiset")) benchContainer<std::multiset<int>>(results, "std::multiset<int>", workload);
+        if (wanted("map")) benchContainer<std::map<int, int>>(results, "std::map<int, int>", workload);
+        if (wanted("multimap")) benchContainer<std::multimap<int, int>>(results, "std::multimap<int, int>", workload);
+        if (wanted("stack")) benchContainer<std::stack<int>>(results, "std::stack<int>", workload);
+        if (wanted("queue")) benchContainer<std::queue<int>>(results, "std::queue<int>", workload);
+        if (wanted("priority_queue")) benchContainer<std::priority_queue<int>>(results, "std::priority_queue<int>", workload);
+        if (wanted("forward_list")) benchContainer<std::forward_list<int>>(results, "std::forward_list<int>", workload);
+        if (wanted("array")) {
+            benchArrays(results, workload, std::index_sequence<10, 100, 1'000, 10'000, 100'000, 1'000'000,
+                                                      10'000'000, 100'000'000>{});
+        }
+        if (wanted("unordered_set")) benchContainer<std::unordered_set<int>>(results, "std::unordered_set<int>", workload);
+        if (wanted("unordered_map")) benchContainer<std::unordered_map<int, int>>(results, "std::unordered_map<int, int>", workload);
+        if (wanted("unordered_multimap")) benchContainer<std::unordered_multimap<int, int>>(results, "std::unordered_multimap<int, int>", workload);
+        if (wanted("unordered_multiset")) benchContainer<std::unordered_multiset<int>>(results, "std::unordered_multiset<int>", workload);
+    }
+
+    if (output.empty()) {
+        writeJson(std::cout, results);
+    } else {
+        std::ofstream file(output);
+        writeJson(file, results);
+    }
+    return 0;
+}
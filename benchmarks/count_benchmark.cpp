@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "count_values.h"
+
+/*
+ * std::count versus countEqual / histogram / countEach from count_values.h.
+ *
+ * single value: std::count against countEqual on each instruction set, for 8, 16,
+ *               32 and 64-bit integers.
+ * K values:     counting K different values of an int vector with values in [0, 256):
+ *               K std::count scans, K countEqual scans, one histogram pass, and countEach
+ *               (which picks one of the last two).
+ *
+ * Usage: count_benchmark [element count, default 10000000]
+ */
+
+// Best time of a few repetitions, in nanoseconds per element.
+template <typename Run>
+double nsPerElement(std::size_t count, Run run) {
+    double best = 1e30;
+    for (int r = 0; r < 5; ++r) {
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    return best * 1e9 / static_cast<double>(count);
+}
+
+template <typename T>
+void compareSingle(const std::string& name, std::size_t count, std::mt19937_64& random) {
+    std::vector<T> values(count);
+    for (T& value : values) {
+        value = static_cast<T>(random() % 64);
+    }
+    const T target = 2;
+
+    std::cout << name << ": std::count " << nsPerElement(count, [&] {
+        doNotOptimize(std::count(values.begin(), values.end(), target));
+    });
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        if (usableSimdLevel(level) != level) {
+            continue;
+        }
+        std::cout << ", countEqual/" << simdLevelName(level) << " " << nsPerElement(count, [&] {
+            doNotOptimize(countEqual(values, target, level));
+        });
+    }
+    std::cout << " ns/element" << std::endl;
+}
+
+void compareMany(std::size_t count, std::mt19937_64& random) {
+    std::vector<int> values(count);
+    for (int& value : values) {
+        value = static_cast<int>(random() % 256);
+    }
+
+    for (std::size_t k : {1, 2, 4, 8, 16, 64, 256}) {
+        std::vector<int> targets(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            targets[i] = static_cast<int>(i * (256 / k));
+        }
+        std::cout << "K=" << k << ": std::count x K " << nsPerElement(count, [&] {
+            for (int target : targets) {
+                doNotOptimize(std::count(values.begin(), values.end(), target));
+            }
+        });
+        std::cout << ", countEqual x K " << nsPerElement(count, [&] {
+            for (int target : targets) {
+                doNotOptimize(countEqual(values, target));
+            }
+        });
+        std::cout << ", histogram " << nsPerElement(count, [&] {
+            doNotOptimize(histogram(values, 0, 255).data());
+        });
+        std::cout << ", countEach " << nsPerElement(count, [&] {
+            doNotOptimize(countEach(values, std::span<const int>(targets)).data());
+        });
+        std::cout << " ns/element" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 10'000'000);
+    std::mt19937_64 random(7);
+
+    std::cout << "Counting one value in " << count << " elements" << std::endl;
+    compareSingle<std::int8_t>("int8_t", count, random);
+    compareSingle<std::int16_t>("int16_t", count, random);
+    compareSingle<std::int32_t>("int32_t", count, random);
+    compareSingle<std::int64_t>("int64_t", count, random);
+
+    std::cout << std::endl << "Counting K values in " << count << " ints" << std::endl;
+    compareMany(count, random);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "bench_util.h"
+#include "ring_deque.h"
+
+/*
+ * std::deque<int> versus ring_deque<int> and its segmented mode (64K-int segments) from
+ * ring_deque.h.
+ *
+ * push_back / push_front:  build a deque of 'count' ints from one end (including growth).
+ * queue:                   steady-state FIFO: push_back + pop_front 'count' times on a
+ *                          deque holding 1000 ints.
+ * iterate:                 sum all elements with a range-for; for ring_deque also
+ *                          through for_each_span (contiguous runs, vectorized).
+ * random access:           sum of 'count' elements at random indices.
+ *
+ * Usage: deque_benchmark [element count, default 10000000]
+ */
+
+using Segmented = ring_deque<int, 1 << 16>;
+
+template <typename Run>
+double bestMs(Run run) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    return best * 1e3;
+}
+
+template <typename Deque>
+void measure(const std::string& name, std::size_t count, const std::vector<std::size_t>& indices) {
+    double pushBack = bestMs([&] {
+        Deque deque;
+        for (std::size_t i = 0; i < count; ++i) {
+            deque.push_back(static_cast<int>(i));
+        }
+        doNotOptimize(deque.back());
+    });
+    double pushFront = bestMs([&] {
+        Deque deque;
+        for (std::size_t i = 0; i < count; ++i) {
+            deque.push_front(static_cast<int>(i));
+        }
+        doNotOptimize(deque.front());
+    });
+    double queue = bestMs([&] {
+        Deque deque;
+        for (int i = 0; i < 1000; ++i) {
+            deque.push_back(i);
+        }
+        long long sum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            deque.push_back(static_cast<int>(i));
+            sum += deque.front();
+            deque.pop_front();
+        }
+        doNotOptimize(sum);
+    });
+
+    Deque deque;
+    for (std::size_t i = 0; i < count; ++i) {
+        // Half at each end, so a ring_deque wraps.
+        if (i % 2 == 0) {
+            deque.push_back(static_cast<int>(i));
+        } else {
+            deque.push_front(static_cast<int>(i));
+        }
+    }
+    double iterate = bestMs([&] {
+        long long sum = 0;
+        for (int value : deque) {
+            sum += value;
+        }
+        doNotOptimize(sum);
+    });
+    double random = bestMs([&] {
+        long long sum = 0;
+        for (std::size_t index : indices) {
+            sum += deque[index];
+        }
+        doNotOptimize(sum);
+    });
+    std::cout << name << ": push_back " << pushBack << " ms, push_front " << pushFront << " ms, queue " << queue
+              << " ms, iterate " << iterate << " ms";
+    if constexpr (!std::is_same_v<Deque, std::deque<int>>) {
+        double spans = bestMs([&] {
+            long long sum = 0;
+            deque.for_each_span([&](auto span) {
+                for (int value : span) {
+                    sum += value;
+                }
+            });
+            doNotOptimize(sum);
+        });
+        std::cout << " (for_each_span " << spans << " ms)";
+    }
+    std::cout << ", random access " << random << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = std::max<std::size_t>(1, sizeArgument(argc, argv, 1, 10'000'000));
+    std::mt19937_64 random(7);
+    std::vector<std::size_t> indices(count);
+    for (std::size_t& index : indices) {
+        index = random() % count;
+    }
+    std::cout << count << " ints" << std::endl;
+    measure<std::deque<int>>("std::deque", count, indices);
+    measure<ring_deque<int>>("ring_deque", count, indices);
+    measure<Segmented>("ring_deque, segmented", count, indices);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "batch_erase.h"
+#include "bench_util.h"
+
+/*
+ * Removing 1%, 10% and 50% of a large std::vector / std::deque of ints.
+ *
+ * Values are uniform in [0, 100000); the elements removed are those below 1000 * percent.
+ * With that as a predicate:
+ *   find + erase        the loop from main.cpp, repeated: O(n) shift per removal
+ *                       (skipped when it would take more than about 2 * 10^10 moves)
+ *   std::erase_if       stable, one pass
+ *   unstableEraseIf     order not kept: holes are filled from the back (batch_erase.h)
+ *   swap-and-pop loop   find + unstableErase per element
+ * and with the same values passed as a value set (hash lookup per element):
+ *   eraseValues, unstableEraseValues
+ *
+ * Usage: erase_benchmark [element count, default 1000000]
+ */
+
+constexpr int valueRange = 100'000;
+constexpr double naiveMoveLimit = 2e10;
+
+// Best time of a few repetitions on a fresh copy of 'input', in milliseconds; the copy is not timed.
+template <typename Container, typename Erase>
+double timeErase(const Container& input, std::size_t expectedSize, Erase erase) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        Container values = input;
+        auto start = BenchClock::now();
+        erase(values);
+        best = std::min(best, secondsSince(start));
+        if (values.size() != expectedSize) {
+            std::cerr << "wrong number of elements removed" << std::endl;
+            std::exit(1);
+        }
+    }
+    return best * 1e3;
+}
+
+template <typename Container>
+void compare(const std::string& name, const Container& input, int percent) {
+    std::vector<int> erased(static_cast<std::size_t>(percent) * valueRange / 100);
+    std::iota(erased.begin(), erased.end(), 0);
+    int limit = static_cast<int>(erased.size());
+    auto isErased = [limit](int value) { return value < limit; };
+    std::size_t removed = static_cast<std::size_t>(std::count_if(input.begin(), input.end(), isErased));
+    std::size_t expectedSize = input.size() - removed;
+
+    std::cout << name << ", removing " << percent << "% (" << removed << " elements):" << std::endl;
+    if (static_cast<double>(removed) * static_cast<double>(input.size()) <= naiveMoveLimit) {
+        std::cout << "  find + erase: " << timeErase(input, expectedSize, [&](Container& c) {
+            auto it = c.begin();
+            while ((it = std::find_if(it, c.end(), isErased)) != c.end()) {
+                it = c.erase(it);
+            }
+        }) << " ms" << std::endl;
+    } else {
+        std::cout << "  find + erase: skipped (O(n * k))" << std::endl;
+    }
+    std::cout << "  std::erase_if: " << timeErase(input, expectedSize, [&](Container& c) {
+        std::erase_if(c, isErased);
+    }) << " ms" << std::endl;
+    std::cout << "  unstableEraseIf: " << timeErase(input, expectedSize, [&](Container& c) {
+        unstableEraseIf(c, isErased);
+    }) << " ms" << std::endl;
+    std::cout << "  swap-and-pop loop: " << timeErase(input, expectedSize, [&](Container& c) {
+        auto it = c.begin();
+        while ((it = std::find_if(it, c.end(), isErased)) != c.end()) {
+            it = unstableErase(c, it);
+        }
+    }) << " ms" << std::endl;
+    std::cout << "  eraseValues (value set): " << timeErase(input, expectedSize, [&](Container& c) {
+        eraseValues(c, std::span<const int>(erased));
+    }) << " ms" << std::endl;
+    std::cout << "  unstableEraseValues (value set): " << timeErase(input, expectedSize, [&](Container& c) {
+        unstableEraseValues(c, std::span<const int>(erased));
+    }) << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 1'000'000);
+    std::mt19937_64 random(7);
+    std::vector<int> vectorInput(count);
+    for (int& value : vectorInput) {
+        value = static_cast<int>(random() % valueRange);
+    }
+    std::deque<int> dequeInput(vectorInput.begin(), vectorInput.end());
+
+    for (int percent : {1, 10, 50}) {
+        compare("vector<int>", vectorInput, percent);
+    }
+    for (int percent : {1, 10, 50}) {
+        compare("deque<int>", dequeInput, percent);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "flat_map.h"
+
+/*
+ * Tree-based std::set / std::map / std::multimap versus the sorted-vector
+ * flat_set / flat_map / flat_multimap from flat_map.h.
+ *
+ * build:   std containers insert one element at a time, flat containers take the
+ *          whole batch with insert(first, last) (one sort + one merge)
+ * find:    look up random keys that are present
+ * iterate: one pass over all elements
+ *
+ * Usage: flat_benchmark [element count, default 1000000]
+ */
+
+constexpr std::size_t lookups = 1'000'000;
+
+template <typename Container, typename Values, typename Keys>
+void run(const std::string& name, const Values& values, const Keys& probes) {
+    auto start = BenchClock::now();
+    Container container;
+    if constexpr (requires { container.reserve(values.size()); }) {
+        container.insert(values.begin(), values.end());
+    } else {
+        for (const auto& value : values) {
+            container.insert(value);
+        }
+    }
+    double buildSeconds = secondsSince(start);
+
+    start = BenchClock::now();
+    std::size_t hits = 0;
+    for (const auto& key : probes) {
+        hits += container.find(key) != container.end();
+    }
+    doNotOptimize(hits);
+    double findSeconds = secondsSince(start);
+
+    start = BenchClock::now();
+    long long sum = 0;
+    for (const auto& element : container) {
+        if constexpr (requires { element.second; }) {
+            sum += element.second;
+        } else {
+            sum += element;
+        }
+    }
+    doNotOptimize(sum);
+    double iterateSeconds = secondsSince(start);
+
+    double n = static_cast<double>(values.size());
+    std::cout << name << ": build " << buildSeconds * 1e9 / n << " ns/element, find "
+              << findSeconds * 1e9 / static_cast<double>(probes.size()) << " ns/lookup, iterate "
+              << iterateSeconds * 1e9 / n << " ns/element" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 1'000'000);
+    std::mt19937_64 random(7);
+
+    std::vector<int> numbers(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        numbers[i] = static_cast<int>(i);
+    }
+    std::shuffle(numbers.begin(), numbers.end(), random);
+
+    std::vector<std::pair<std::string, int>> entries;
+    entries.reserve(count);
+    for (int value : numbers) {
+        entries.emplace_back("key" + std::to_string(value), value);
+    }
+
+    std::uniform_int_distribution<std::size_t> position(0, count - 1);
+    std::vector<int> numberProbes(lookups);
+    std::vector<std::string> keyProbes(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        std::size_t index = position(random);
+        numberProbes[i] = numbers[index];
+        keyProbes[i] = entries[index].first;
+    }
+
+    std::cout << count << " elements, " << lookups << " lookups" << std::endl;
+    run<std::set<int>>("std::set<int>                  ", numbers, numberProbes);
+    run<flat_set<int>>("flat_set<int>                  ", numbers, numberProbes);
+    run<std::map<std::string, int>>("std::map<std::string, int>     ", entries, keyProbes);
+    run<flat_map<std::string, int>>("flat_map<std::string, int>     ", entries, keyProbes);
+    run<std::multimap<std::string, int>>("std::multimap<std::string, int>", entries, keyProbes);
+    run<flat_multimap<std::string, int>>("flat_multimap<std::string, int>", entries, keyProbes);
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "priority_heaps.h"
+
+/*
+ * std::priority_queue versus DaryHeap, IndexedHeap and RadixHeap from priority_heaps.h.
+ *
+ * push / pop:  push 'count' random keys, then pop them all (min-queues).
+ * hold:        the classic event-queue pattern at a steady size: pop the smallest key and
+ *              push it back plus a random delay, 'count' times, for queue sizes from 1K
+ *              up to 'count'.
+ * dijkstra:    shortest paths on a random graph with 'count' vertices and 8 edges each.
+ *              std::priority_queue and RadixHeap push a vertex again when its distance
+ *              drops and skip stale entries ("lazy deletion"); IndexedHeap holds each
+ *              vertex once and lowers its key with update() (decrease-key).
+ *
+ * Usage: heap_benchmark [count, default 1000000]
+ */
+
+using Key = std::uint32_t;
+using MinQueue = std::priority_queue<Key, std::vector<Key>, std::greater<Key>>;
+
+template <typename Run>
+double bestMs(Run run) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    return best * 1e3;
+}
+
+void pushPop(const std::vector<Key>& keys) {
+    auto checked = [](std::uint64_t sum, std::uint64_t expected) {
+        if (sum != expected) {
+            std::cerr << "heap returned wrong keys" << std::endl;
+            std::exit(1);
+        }
+    };
+    std::uint64_t expected = 0;
+    for (Key key : keys) {
+        expected += key;
+    }
+    double standard = bestMs([&] {
+        MinQueue queue;
+        std::uint64_t sum = 0;
+        for (Key key : keys) {
+            queue.push(key);
+        }
+        for (; !queue.empty(); queue.pop()) {
+            sum += queue.top();
+        }
+        checked(sum, expected);
+    });
+    double binary = bestMs([&] {
+        DaryHeap<Key, 2, std::greater<Key>> heap;
+        std::uint64_t sum = 0;
+        for (Key key : keys) {
+            heap.push(key);
+        }
+        for (; !heap.empty(); heap.pop()) {
+            sum += heap.top();
+        }
+        checked(sum, expected);
+    });
+    double quaternary = bestMs([&] {
+        DaryHeap<Key, 4, std::greater<Key>> heap;
+        std::uint64_t sum = 0;
+        for (Key key : keys) {
+            heap.push(key);
+        }
+        for (; !heap.empty(); heap.pop()) {
+            sum += heap.top();
+        }
+        checked(sum, expected);
+    });
+    double radix = bestMs([&] {
+        RadixHeap<Key, char> heap;
+        std::uint64_t sum = 0;
+        for (Key key : keys) {
+            heap.push(key, 0);
+        }
+        while (!heap.empty()) {
+            sum += heap.pop().first;
+        }
+        checked(sum, expected);
+    });
+    std::cout << "push / pop " << keys.size() << " keys: std::priority_queue " << standard << " ms, DaryHeap<2> "
+              << binary << " ms, DaryHeap<4> " << quaternary << " ms, RadixHeap " << radix << " ms" << std::endl;
+}
+
+// 'operations' pops, each followed by a push of the popped key plus one of 'delays'.
+template <typename Heap, typename Push, typename PopMin>
+std::uint64_t hold(Heap& heap, const std::vector<Key>& delays, std::size_t operations, Push push, PopMin popMin) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < operations; ++i) {
+        Key key = popMin(heap);
+        sum += key;
+        push(heap, key + delays[i % delays.size()]);
+    }
+    return sum;
+}
+
+void holdModel(std::size_t size, std::size_t operations, std::mt19937_64& random) {
+    std::vector<Key> initial(size);
+    std::vector<Key> delays(1 << 16);
+    for (Key& key : initial) {
+        key = static_cast<Key>(random() % 1'000'000);
+    }
+    for (Key& delay : delays) {
+        delay = static_cast<Key>(random() % 1'000'000);
+    }
+    std::uint64_t expected = 0;
+    auto run = [&](auto heap, auto push, auto popMin) {
+        for (Key key : initial) {
+            push(heap, key);
+        }
+        std::uint64_t sum = hold(heap, delays, operations, push, popMin);
+        if (expected == 0) {
+            expected = sum;
+        } else if (sum != expected) {
+            std::cerr << "heaps disagree on the hold model" << std::endl;
+            std::exit(1);
+        }
+    };
+    double standard = bestMs([&] {
+        run(MinQueue(), [](MinQueue& heap, Key key) { heap.push(key); }, [](MinQueue& heap) {
+            Key key = heap.top();
+            heap.pop();
+            return key;
+        });
+    });
+    using Quaternary = DaryHeap<Key, 4, std::greater<Key>>;
+    double quaternary = bestMs([&] {
+        run(Quaternary(), [](Quaternary& heap, Key key) { heap.push(key); }, [](Quaternary& heap) {
+            Key key = heap.top();
+            heap.pop();
+            return key;
+        });
+    });
+    using Radix = RadixHeap<Key, char>;
+    double radix = bestMs([&] {
+        run(Radix(), [](Radix& heap, Key key) { heap.push(key, 0); }, [](Radix& heap) { return heap.pop().first; });
+    });
+    std::cout << "hold, size " << size << ", " << operations << " pop + push: std::priority_queue " << standard
+              << " ms, DaryHeap<4> " << quaternary << " ms, RadixHeap " << radix << " ms" << std::endl;
+}
+
+struct Graph {
+    std::vector<std::size_t> firstEdge;
+    std::vector<std::uint32_t> target;
+    std::vector<Key> weight;
+};
+
+Graph randomGraph(std::size_t vertices, std::size_t degree, std::mt19937_64& random) {
+    Graph graph;
+    graph.firstEdge.resize(vertices + 1);
+    for (std::size_t v = 0; v <= vertices; ++v) {
+        graph.firstEdge[v] = v * degree;
+    }
+    graph.target.resize(vertices * degree);
+    graph.weight.resize(vertices * degree);
+    for (std::size_t e = 0; e < vertices * degree; ++e) {
+        graph.target[e] = static_cast<std::uint32_t>(random() % vertices);
+        graph.weight[e] = static_cast<Key>(1 + random() % 1000);
+    }
+    return graph;
+}
+
+constexpr Key unreachable = std::numeric_limits<Key>::max();
+
+// Lazy deletion: 'Queue' holds (distance, vertex) entries, stale ones are skipped.
+template <typename Push, typename Pop, typename Empty>
+std::vector<Key> dijkstraLazy(const Graph& graph, Push push, Pop pop, Empty empty) {
+    std::vector<Key> distance(graph.firstEdge.size() - 1, unreachable);
+    distance[0] = 0;
+    push(0, 0);
+    while (!empty()) {
+        auto [d, v] = pop();
+        if (d != distance[v]) {
+            continue;
+        }
+        for (std::size_t e = graph.firstEdge[v]; e < graph.firstEdge[v + 1]; ++e) {
+            Key candidate = d + graph.weight[e];
+            if (candidate < distance[graph.target[e]]) {
+                distance[graph.target[e]] = candidate;
+                push(candidate, graph.target[e]);
+            }
+        }
+    }
+    return distance;
+}
+
+std::vector<Key> dijkstraIndexed(const Graph& graph) {
+    std::size_t vertices = graph.firstEdge.size() - 1;
+    std::vector<Key> distance(vertices, unreachable);
+    IndexedHeap<Key, std::greater<Key>> heap(vertices);
+    distance[0] = 0;
+    heap.push(0, 0);
+    while (!heap.empty()) {
+        std::size_t v = heap.topId();
+        Key d = heap.top();
+        heap.pop();
+        for (std::size_t e = graph.firstEdge[v]; e < graph.firstEdge[v + 1]; ++e) {
+            std::uint32_t to = graph.target[e];
+            Key candidate = d + graph.weight[e];
+            if (candidate < distance[to]) {
+                if (distance[to] == unreachable) {
+                    heap.push(to, candidate);
+                } else {
+                    heap.update(to, candidate);
+                }
+                distance[to] = candidate;
+            }
+        }
+    }
+    return distance;
+}
+
+void dijkstra(std::size_t vertices, std::mt19937_64& random) {
+    Graph graph = randomGraph(vertices, 8, random);
+    using Entry = std::pair<Key, std::uint32_t>;
+    std::vector<Key> expected;
+    auto check = [&](const std::vector<Key>& distance) {
+        if (expected.empty()) {
+            expected = distance;
+        } else if (distance != expected) {
+            std::cerr << "shortest paths differ" << std::endl;
+            std::exit(1);
+        }
+    };
+    double standard = bestMs([&] {
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        check(dijkstraLazy(graph, [&](Key d, std::uint32_t v) { queue.emplace(d, v); }, [&] {
+            Entry top = queue.top();
+            queue.pop();
+            return top;
+        }, [&] { return queue.empty(); }));
+    });
+    double indexed = bestMs([&] { check(dijkstraIndexed(graph)); });
+    double radix = bestMs([&] {
+        RadixHeap<Key, std::uint32_t> heap;
+        check(dijkstraLazy(graph, [&](Key d, std::uint32_t v) { heap.push(d, v); }, [&] { return heap.pop(); },
+                           [&] { return heap.empty(); }));
+    });
+    std::cout << "dijkstra, " << vertices << " vertices, " << graph.target.size()
+              << " edges: std::priority_queue (lazy) " << standard << " ms, IndexedHeap (decrease-key) " << indexed
+              << " ms, RadixHeap (lazy) " << radix << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 1'000'000);
+    std::mt19937_64 random(7);
+    std::vector<Key> keys(count);
+    for (Key& key : keys) {
+        key = static_cast<Key>(random());
+    }
+    pushPop(keys);
+    std::cout << std::endl;
+    for (std::size_t size = 1000; size <= count; size *= 10) {
+        holdModel(size, count, random);
+    }
+    std::cout << std::endl;
+    dijkstra(count, random);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "container_algorithms.h"
+
+/*
+ * The generic algorithm versus containerSort / containerFind / containerCount from
+ * container_algorithms.h.
+ *
+ * sort:  list::sort / forward_list::sort versus containerSort, for std::list<int> and
+ *        std::forward_list<int>, with std::sort on a vector as reference. "scattered" lists were sorted once before, so walking them in
+ *        order jumps around memory like a list that lived through many inserts and erases.
+ * find:  std::find versus containerFind on a std::set<int> (member find).
+ * count: std::count versus containerCount on a std::vector<int> (SIMD countEqual).
+ *
+ * Usage: list_algorithms_benchmark [element count, default 1000000]
+ */
+
+// Best time of a few runs in milliseconds; 'prepare' runs untimed before each one.
+template <typename Prepare, typename Run>
+double bestMs(Prepare prepare, Run run) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        prepare();
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    return best * 1e3;
+}
+
+// Sorts a list, then refills it with 'values' in list order: the nodes end up in random memory order.
+template <typename List, typename T>
+List scatteredList(const std::vector<T>& values) {
+    List list(values.begin(), values.end());
+    list.sort();
+    std::copy(values.begin(), values.end(), list.begin());
+    return list;
+}
+
+template <typename List, typename T>
+void compareSort(const std::string& name, const std::vector<T>& values) {
+    for (bool scattered : {false, true}) {
+        List list;
+        auto reset = [&] { list = scattered ? scatteredList<List>(values) : List(values.begin(), values.end()); };
+        double member = bestMs(reset, [&] { list.sort(); });
+        double dispatched = bestMs(reset, [&] { containerSort(list); });
+        if (!std::is_sorted(list.begin(), list.end())) {
+            std::cerr << "containerSort did not sort" << std::endl;
+            std::exit(1);
+        }
+        std::cout << name << (scattered ? ", scattered" : ", fresh") << ": member sort " << member
+                  << " ms, containerSort " << dispatched << " ms (" << member / dispatched << "x)" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 1'000'000);
+    std::mt19937_64 random(7);
+    std::vector<int> ints(count);
+    for (int& value : ints) {
+        value = static_cast<int>(random());
+    }
+
+    std::vector<int> sortedInts;
+    std::cout << "vector<int>: std::sort " << bestMs([&] { sortedInts = ints; }, [&] {
+        std::sort(sortedInts.begin(), sortedInts.end());
+    }) << " ms" << std::endl;
+    compareSort<std::list<int>>("list<int>", ints);
+    compareSort<std::forward_list<int>>("forward_list<int>", ints);
+
+    std::set<int> set(ints.begin(), ints.end());
+    std::vector<int> queries(10);
+    for (int& query : queries) {
+        query = ints[random() % count];
+    }
+    double linear = bestMs([] {}, [&] {
+        for (int query : queries) {
+            doNotOptimize(std::find(set.begin(), set.end(), query));
+        }
+    });
+    double member = bestMs([] {}, [&] {
+        for (int query : queries) {
+            doNotOptimize(containerFind(set, query));
+        }
+    });
+    std::cout << std::endl << "set<int>, " << queries.size() << " finds: std::find " << linear << " ms, containerFind "
+              << member << " ms (" << linear / member << "x)" << std::endl;
+
+    std::vector<int> small(count);
+    for (int& value : small) {
+        value = static_cast<int>(random() % 16);
+    }
+    double generic = bestMs([] {}, [&] { doNotOptimize(std::count(small.begin(), small.end(), 3)); });
+    double simd = bestMs([] {}, [&] { doNotOptimize(containerCount(small, 3)); });
+    std::cout << "vector<int>: std::count " << generic << " ms, containerCount " << simd << " ms ("
+              << generic / simd << "x)" << std::endl;
+    return 0;
+}
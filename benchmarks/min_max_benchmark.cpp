@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "min_max.h"
+
+/*
+ * std::min_element + std::max_element (two passes) and std::minmax_element versus
+ * the one-pass minMax from min_max.h, forced to its scalar, SSE4.1 and AVX2 kernels.
+ *
+ * Sizes go from 1000 elements up to the given maximum in steps of 10, for int, float
+ * and double. Levels the CPU does not support are skipped.
+ *
+ * Usage: min_max_benchmark [max element count, default 100000000]
+ */
+
+// Best time of a few repetitions, in nanoseconds per element.
+template <typename Run>
+double nsPerElement(std::size_t count, Run run) {
+    std::size_t repetitions = std::clamp<std::size_t>(100'000'000 / count, 3, 1000);
+    double best = 1e30;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    return best * 1e9 / static_cast<double>(count);
+}
+
+template <typename T>
+void compare(const std::string& name, std::size_t count, std::mt19937_64& random) {
+    std::vector<T> values(count);
+    std::uniform_real_distribution<double> distribution(-1e9, 1e9);
+    for (T& value : values) {
+        value = static_cast<T>(distribution(random));
+    }
+
+    std::cout << name << " n=" << count << ":";
+    std::cout << " min_element+max_element " << nsPerElement(count, [&] {
+        doNotOptimize(*std::min_element(values.begin(), values.end()));
+        doNotOptimize(*std::max_element(values.begin(), values.end()));
+    });
+    std::cout << ", minmax_element " << nsPerElement(count, [&] {
+        auto [low, high] = std::minmax_element(values.begin(), values.end());
+        doNotOptimize(*low);
+        doNotOptimize(*high);
+    });
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        if (usableSimdLevel(level) != level) {
+            continue;
+        }
+        std::cout << ", minMax/" << simdLevelName(level) << " " << nsPerElement(count, [&] {
+            doNotOptimize(minMax(values, level));
+        });
+    }
+    std::cout << " ns/element" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t maxCount = sizeArgument(argc, argv, 1, 100'000'000);
+    std::mt19937_64 random(7);
+
+    for (std::size_t count = 1000; count <= maxCount; count *= 10) {
+        compare<int>("int", count, random);
+        compare<float>("float", count, random);
+        compare<double>("double", count, random);
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "mpmc_queue.h"
+
+/*
+ * Many producers and consumers passing ints through one bounded queue: std::queue with a
+ * std::mutex and two std::condition_variables (not full / not empty) versus MpmcQueue from
+ * mpmc_queue.h with blocking push / pop and with tryPush / tryPop in a yield loop.
+ *
+ * For 2, 4, 8, ... 'max threads' threads, half produce and half consume; 'count' ints go
+ * through the queue in total. Each row is the best of three runs in millions of elements
+ * per second. Thread counts above the number of CPUs measure how each queue copes with
+ * oversubscription.
+ *
+ * Usage: mpmc_benchmark [element count, default 4000000] [max threads, default 64]
+ */
+
+constexpr std::size_t queueCapacity = 1 << 12;
+
+// Bounded std::queue behind a lock, waiting on condition variables when full or empty.
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(int value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return queue_.size() < capacity_; });
+        queue_.push(value);
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    int pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !queue_.empty(); });
+        int value = queue_.front();
+        queue_.pop();
+        lock.unlock();
+        notFull_.notify_one();
+        return value;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::queue<int> queue_;
+    std::size_t capacity_;
+};
+
+// Runs 'producers' threads calling push(queue, value) and 'consumers' threads calling pop(queue);
+// checks that every value arrived exactly once. Seconds for the whole transfer.
+template <typename Queue, typename Push, typename Pop>
+double transfer(std::size_t count, std::size_t producers, std::size_t consumers, Push push, Pop pop) {
+    Queue queue(queueCapacity);
+    std::vector<std::uint64_t> sums(consumers);
+    std::vector<std::thread> threads;
+    auto start = BenchClock::now();
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = p; i < count; i += producers) {
+                push(queue, static_cast<int>(i));
+            }
+        });
+    }
+    for (std::size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::uint64_t sum = 0;
+            for (std::size_t i = c; i < count; i += consumers) {
+                sum += static_cast<std::uint64_t>(pop(queue));
+            }
+            sums[c] = sum;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = secondsSince(start);
+    std::uint64_t total = 0;
+    for (std::uint64_t sum : sums) {
+        total += sum;
+    }
+    if (total != static_cast<std::uint64_t>(count) * (count - 1) / 2) {
+        std::cerr << "lost or duplicated elements" << std::endl;
+        std::exit(1);
+    }
+    return seconds;
+}
+
+template <typename Queue, typename Push, typename Pop>
+double millionsPerSecond(std::size_t count, std::size_t producers, std::size_t consumers, Push push, Pop pop) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        best = std::min(best, transfer<Queue>(count, producers, consumers, push, pop));
+    }
+    return static_cast<double>(count) / best / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 4'000'000);
+    std::size_t maxThreads = sizeArgument(argc, argv, 2, 64);
+    std::cout << count << " ints, capacity " << queueCapacity << ", " << std::thread::hardware_concurrency()
+              << " hardware threads, M elements/s" << std::endl;
+
+    for (std::size_t threads = 2; threads <= std::max<std::size_t>(maxThreads, 2); threads *= 2) {
+        std::size_t producers = threads / 2;
+        std::size_t consumers = producers;
+        double locked = millionsPerSecond<LockedQueue>(count, producers, consumers,
+            [](LockedQueue& queue, int value) { queue.push(value); },
+            [](LockedQueue& queue) { return queue.pop(); });
+        double blocking = millionsPerSecond<MpmcQueue<int>>(count, producers, consumers,
+            [](MpmcQueue<int>& queue, int value) { queue.push(value); },
+            [](MpmcQueue<int>& queue) { return queue.pop(); });
+        double polling = millionsPerSecond<MpmcQueue<int>>(count, producers, consumers,
+            [](MpmcQueue<int>& queue, int value) {
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            },
+            [](MpmcQueue<int>& queue) {
+                int value;
+                while (!queue.tryPop(value)) {
+                    std::this_thread::yield();
+                }
+                return value;
+            });
+        std::cout << producers << " producer(s) + " << consumers << " consumer(s): mutex + condvar + std::queue "
+                  << locked << ", MpmcQueue push / pop " << blocking << ", MpmcQueue tryPush / tryPop " << polling
+                  << std::endl;
+    }
+    return 0;
+}
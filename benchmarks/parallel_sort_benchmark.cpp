@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "parallel_sort.h"
+
+#if defined(STL_PARALLEL_STL)
+#include <execution>
+#include <tbb/global_control.h>
+#endif
+
+/*
+ * std::sort versus parallelSort from parallel_sort.h (and std::sort(std::execution::par)
+ * when built with TBB), on 1, 2, 4, ... up to N threads.
+ *
+ * Inputs: random ints, ints with only 16 distinct values and random doubles in a
+ * std::vector, and random ints in a std::deque. At N threads parallelSort is also run
+ * with a few grain sizes.
+ *
+ * Usage: parallel_sort_benchmark [element count, default 10000000] [max threads, default: hardware threads]
+ */
+
+template <typename Container, typename Sort>
+double timeSort(const Container& input, Sort sort) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        Container values = input;
+        auto start = BenchClock::now();
+        sort(values);
+        best = std::min(best, secondsSince(start));
+        if (!std::is_sorted(values.begin(), values.end())) {
+            std::cerr << "result is not sorted" << std::endl;
+            std::exit(1);
+        }
+    }
+    return best;
+}
+
+std::vector<std::size_t> threadCounts(std::size_t maxThreads) {
+    std::vector<std::size_t> counts;
+    for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+template <typename Container>
+void compare(const std::string& name, const Container& input, std::size_t maxThreads) {
+    double n = static_cast<double>(input.size());
+    double stdSeconds = timeSort(input, [](Container& c) { std::sort(c.begin(), c.end()); });
+    std::cout << name << ": std::sort " << stdSeconds * 1e9 / n << " ns/element" << std::endl;
+
+    for (std::size_t threads : threadCounts(maxThreads)) {
+        ThreadPool pool(threads);
+        double seconds = timeSort(input, [&](Container& c) { parallelSort(pool, c.begin(), c.end()); });
+        std::cout << "  " << threads << " thread(s): parallelSort " << seconds * 1e9 / n << " ns/element ("
+                  << stdSeconds / seconds << "x)";
+#if defined(STL_PARALLEL_STL)
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, threads);
+        double parSeconds = timeSort(input, [](Container& c) { std::sort(std::execution::par, c.begin(), c.end()); });
+        std::cout << ", std::sort(par) " << parSeconds * 1e9 / n << " ns/element (" << stdSeconds / parSeconds << "x)";
+#endif
+        std::cout << std::endl;
+    }
+
+    ThreadPool pool(maxThreads);
+    for (std::size_t grain : {std::size_t(1) << 10, std::size_t(1) << 12, std::size_t(1) << 14, std::size_t(1) << 16}) {
+        double seconds = timeSort(input, [&](Container& c) {
+            parallelSort(pool, c.begin(), c.end(), std::less<>{}, grain);
+        });
+        std::cout << "  " << maxThreads << " thread(s), grain " << grain << ": parallelSort "
+                  << seconds * 1e9 / n << " ns/element" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 10'000'000);
+    std::size_t maxThreads = sizeArgument(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+    std::mt19937_64 random(7);
+
+    std::vector<int> randomInts(count);
+    for (int& value : randomInts) {
+        value = static_cast<int>(random());
+    }
+    std::vector<int> fewDistinct(count);
+    for (int& value : fewDistinct) {
+        value = static_cast<int>(random() % 16);
+    }
+    std::vector<double> randomDoubles(count);
+    std::uniform_real_distribution<double> distribution(-1e9, 1e9);
+    for (double& value : randomDoubles) {
+        value = distribution(random);
+    }
+    std::deque<int> dequeInts(randomInts.begin(), randomInts.end());
+
+    compare("vector<int>, random", randomInts, maxThreads);
+    compare("vector<int>, 16 distinct values", fewDistinct, maxThreads);
+    compare("vector<double>, random", randomDoubles, maxThreads);
+    compare("deque<int>, random", dequeInts, maxThreads);
+    return 0;
+}
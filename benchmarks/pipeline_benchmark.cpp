@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "pipeline.h"
+
+/*
+ * Eager algorithm chains versus the fused, lazy pipeline from pipeline.h, on an int vector
+ * much larger than the caches, so the cost is memory traffic.
+ *
+ * sum of squares:             std::transform in place + std::accumulate (what main.cpp
+ *                             does), std::transform into a new vector + std::accumulate,
+ *                             std::views::transform, pipeline().map().sum(), hand-written loop
+ * sum of squares below 500:   std::copy_if + std::transform + std::accumulate,
+ *                             views::filter | views::transform, pipeline().filter().map().sum(),
+ *                             hand-written loop
+ *
+ * "GB/s" is the size of the input divided by the time: an eager chain that moves the data
+ * several times shows up as a lower rate.
+ *
+ * Usage: pipeline_benchmark [element count, default 50000000]
+ */
+
+// Best time of a few runs; 'prepare' runs untimed before each one.
+template <typename Run, typename Prepare = void (*)()>
+void row(const std::string& name, const std::vector<int>& input, long long expected, Run run, Prepare prepare = [] {}) {
+    double best = 1e30;
+    long long result = 0;
+    for (int r = 0; r < 3; ++r) {
+        prepare();
+        auto start = BenchClock::now();
+        result = run();
+        best = std::min(best, secondsSince(start));
+    }
+    double bytes = static_cast<double>(input.size() * sizeof(int));
+    std::cout << "  " << name << ": " << best * 1e3 << " ms, " << bytes / best / 1e9 << " GB/s"
+              << (result == expected ? "" : ", WRONG RESULT") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 50'000'000);
+    std::mt19937_64 random(7);
+    std::vector<int> input(count);
+    for (int& value : input) {
+        value = static_cast<int>(random() % 1000);
+    }
+    auto square = [](int x) { return static_cast<long long>(x) * x; };
+    auto small = [](int x) { return x < 500; };
+
+    long long sumOfSquares = 0;
+    long long sumOfSmallSquares = 0;
+    for (int value : input) {
+        sumOfSquares += square(value);
+        sumOfSmallSquares += small(value) ? square(value) : 0;
+    }
+
+    std::cout << count << " ints, sum of squares" << std::endl;
+    std::vector<int> work(count);
+    row("transform in place + accumulate", input, sumOfSquares, [&] {
+        std::transform(work.begin(), work.end(), work.begin(), [](int x) { return x * x; });
+        return std::accumulate(work.begin(), work.end(), 0LL);
+    }, [&] { std::copy(input.begin(), input.end(), work.begin()); });
+    row("transform into new vector + accumulate", input, sumOfSquares, [&] {
+        std::vector<long long> squares(input.size());
+        std::transform(input.begin(), input.end(), squares.begin(), square);
+        return std::accumulate(squares.begin(), squares.end(), 0LL);
+    });
+    row("views::transform + accumulate", input, sumOfSquares, [&] {
+        auto squares = input | std::views::transform(square);
+        return std::accumulate(squares.begin(), squares.end(), 0LL);
+    });
+    row("pipeline map + sum", input, sumOfSquares, [&] {
+        return pipeline(input).map(square).sum();
+    });
+    row("hand-written loop", input, sumOfSquares, [&] {
+        long long total = 0;
+        for (int value : input) {
+            total += square(value);
+        }
+        return total;
+    });
+
+    std::cout << std::endl << count << " ints, sum of squares below 500" << std::endl;
+    row("copy_if + transform + accumulate", input, sumOfSmallSquares, [&] {
+        std::vector<int> kept;
+        std::copy_if(input.begin(), input.end(), std::back_inserter(kept), small);
+        std::vector<long long> squares(kept.size());
+        std::transform(kept.begin(), kept.end(), squares.begin(), square);
+        return std::accumulate(squares.begin(), squares.end(), 0LL);
+    });
+    row("views::filter | views::transform + accumulate", input, sumOfSmallSquares, [&] {
+        auto squares = input | std::views::filter(small) | std::views::transform(square);
+        return std::accumulate(squares.begin(), squares.end(), 0LL);
+    });
+    row("pipeline filter + map + sum", input, sumOfSmallSquares, [&] {
+        return pipeline(input).filter(small).map(square).sum();
+    });
+    row("hand-written loop", input, sumOfSmallSquares, [&] {
+        long long total = 0;
+        for (int value : input) {
+            if (small(value)) {
+                total += square(value);
+            }
+        }
+        return total;
+    });
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cstdint>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "bench_util.h"
+#include "pool_allocator.h"
+
+/*
+ * std::list<int> and std::forward_list<int> with std::allocator versus pooled_list and
+ * pooled_forward_list from pool_allocator.h.
+ *
+ * build:     append 'count' ints to an empty list.
+ * scattered: the same, but every node allocation is followed by an unrelated allocation
+ *            of 16 to 128 bytes that stays alive, as in a program that does more than
+ *            fill one list. The rest of the benchmark runs on this list.
+ * traverse:  sum the list, in ns per node, with hardware cache misses per node when the
+ *            kernel lets us count them (perf_event_open; "n/a" otherwise).
+ * churn:     four passes over the list, erasing a quarter of the nodes and inserting a
+ *            new node next to another quarter, in ns per insert or erase (the walk to
+ *            the position included). Afterwards the list is traversed again.
+ * destroy:   the list's destructor.
+ *
+ * Usage: pool_allocator_benchmark [element count, default 1000000]
+ */
+
+constexpr int churnPasses = 4;
+
+// Counts hardware cache misses of this thread between start() and stop().
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attributes{};
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool available() const {
+        return fd_ >= 0;
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+        long long misses = 0;
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &misses, sizeof(misses)) != static_cast<ssize_t>(sizeof(misses))) {
+                misses = 0;
+            }
+        }
+#endif
+        return misses;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+template <typename List>
+constexpr bool singlyLinked = requires(List& list) { list.before_begin(); };
+
+template <typename List>
+void append(List& list, int value) {
+    if constexpr (singlyLinked<List>) {
+        list.push_front(value);
+    } else {
+        list.push_back(value);
+    }
+}
+
+// One churn pass: erases about a quarter of the nodes and inserts a new node after
+// another quarter. Returns the number of inserts and erases.
+template <typename List>
+std::size_t churnPass(List& list, std::mt19937_64& random) {
+    std::size_t operations = 0;
+    if constexpr (singlyLinked<List>) {
+        for (auto before = list.before_begin(); std::next(before) != list.end();) {
+            std::uint64_t dice = random() % 4;
+            if (dice == 0) {
+                list.erase_after(before);
+                ++operations;
+            } else {
+                ++before;
+                if (dice == 1) {
+                    before = list.insert_after(before, static_cast<int>(dice));
+                    ++operations;
+                }
+            }
+        }
+    } else {
+        for (auto it = list.begin(); it != list.end();) {
+            std::uint64_t dice = random() % 4;
+            if (dice == 0) {
+                it = list.erase(it);
+                ++operations;
+            } else {
+                ++it;
+                if (dice == 1) {
+                    list.insert(it, static_cast<int>(dice));
+                    ++operations;
+                }
+            }
+        }
+    }
+    return operations;
+}
+
+template <typename List>
+std::string traverse(const List& list, CacheMissCounter& misses) {
+    std::size_t nodes = 0;
+    double best = 1e30;
+    long long fewestMisses = 0;
+    for (int r = 0; r < 3; ++r) {
+        long long sum = 0;
+        nodes = 0;
+        misses.start();
+        auto start = BenchClock::now();
+        for (int value : list) {
+            sum += value;
+            ++nodes;
+        }
+        double seconds = secondsSince(start);
+        long long counted = misses.stop();
+        doNotOptimize(sum);
+        if (seconds < best) {
+            best = seconds;
+            fewestMisses = counted;
+        }
+    }
+    nodes = std::max<std::size_t>(nodes, 1);
+    std::string result = std::to_string(best * 1e9 / static_cast<double>(nodes)) + " ns/node";
+    if (misses.available()) {
+        result += " (" + std::to_string(static_cast<double>(fewestMisses) / static_cast<double>(nodes)) +
+                  " misses/node)";
+    } else {
+        result += " (misses n/a)";
+    }
+    return result;
+}
+
+template <typename List>
+void measure(const std::string& name, std::size_t count, CacheMissCounter& misses) {
+    double build = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto start = BenchClock::now();
+        List list;
+        for (std::size_t i = 0; i < count; ++i) {
+            append(list, static_cast<int>(i));
+        }
+        doNotOptimize(list.front());
+        build = std::min(build, secondsSince(start));
+    }
+    std::string fresh;
+    {
+        List list;
+        for (std::size_t i = 0; i < count; ++i) {
+            append(list, static_cast<int>(i));
+        }
+        fresh = traverse(list, misses);
+    }
+
+    std::mt19937_64 random(7);
+    std::vector<std::unique_ptr<char[]>> others;
+    others.reserve(count);
+    std::optional<List> list(std::in_place);
+    auto start = BenchClock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        append(*list, static_cast<int>(i));
+        others.emplace_back(new char[16 + random() % 113]);
+    }
+    double scattered = secondsSince(start);
+    std::string scatteredTraverse = traverse(*list, misses);
+
+    std::size_t operations = 0;
+    start = BenchClock::now();
+    for (int pass = 0; pass < churnPasses; ++pass) {
+        operations += churnPass(*list, random);
+    }
+    double churn = secondsSince(start);
+    std::string churnedTraverse = traverse(*list, misses);
+
+    start = BenchClock::now();
+    list.reset();
+    double destroy = secondsSince(start);
+
+    std::cout << name << std::endl;
+    std::cout << "  build " << build * 1e3 << " ms, traverse " << fresh << std::endl;
+    std::cout << "  scattered build " << scattered * 1e3 << " ms, traverse " << scatteredTraverse << std::endl;
+    std::cout << "  churn " << churn * 1e9 / static_cast<double>(std::max<std::size_t>(operations, 1))
+              << " ns/op, traverse " << churnedTraverse << std::endl;
+    std::cout << "  destroy " << destroy * 1e3 << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = std::max<std::size_t>(1, sizeArgument(argc, argv, 1, 1'000'000));
+    CacheMissCounter misses;
+    std::cout << count << " ints" << (misses.available() ? "" : ", cache miss counter not available") << std::endl;
+    measure<std::list<int>>("std::list", count, misses);
+    measure<pooled_list<int>>("pooled_list", count, misses);
+    measure<std::forward_list<int>>("std::forward_list", count, misses);
+    measure<pooled_forward_list<int>>("pooled_forward_list", count, misses);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "output_sink.h"
+#include "printers.h"
+
+/*
+ * Measures how fast the print* templates can dump big containers,
+ * once through a std::ostream and once through an OutputSink.
+ * Output goes to /dev/null so we measure formatting and writing, not the terminal.
+ *
+ * Usage: print_benchmark [element count, default 10000000]
+ */
+
+// Runs 'print' against /dev/null, first through a std::ofstream and then through an OutputSink.
+// Both produce the same text, so the byte count from the sink is used for both rates.
+template <typename Print>
+void compare(const std::string& name, Print print) {
+    auto start = BenchClock::now();
+    {
+        std::ofstream file("/dev/null");
+        print(file);
+        file.flush();
+    }
+    double streamSeconds = secondsSince(start);
+
+    int fd = ::open("/dev/null", O_WRONLY);
+    start = BenchClock::now();
+    std::size_t bytes;
+    {
+        OutputSink sink(fd, 1 << 20);
+        print(sink);
+        sink.flush();
+        bytes = sink.bytesWritten();
+    }
+    double sinkSeconds = secondsSince(start);
+    ::close(fd);
+
+    auto rate = [bytes](double seconds) {
+        return (bytes / seconds) / (1024.0 * 1024.0);
+    };
+    std::cout << name << ": " << bytes << " bytes\n"
+              << "    std::ostream: " << streamSeconds << " s, " << rate(streamSeconds) << " MiB/s\n"
+              << "    OutputSink:   " << sinkSeconds << " s, " << rate(sinkSeconds) << " MiB/s" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 10'000'000);
+
+    std::vector<int> numbers(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        numbers[i] = static_cast<int>(i * 2654435761u);
+    }
+    std::map<int, int> myMap;
+    for (std::size_t i = 0; i < count; ++i) {
+        myMap.emplace_hint(myMap.end(), static_cast<int>(i), static_cast<int>(i * 7));
+    }
+
+    std::cout << "Printing " << count << " elements" << std::endl;
+
+    // The old element-by-element loop, for comparison with printContainer's bulk integer path.
+    compare("vector<int>, operator<< per element", [&](auto& out) {
+        out << "Printing: ";
+        for (const auto& el : numbers) {
+            out << el << " ";
+        }
+        out << '\n';
+    });
+    compare("vector<int>, printContainer", [&](auto& out) {
+        printContainer(numbers, out);
+    });
+    compare("map<int, int>, printContainer", [&](auto& out) {
+        printContainer(myMap, out);
+    });
+
+    return 0;
+}
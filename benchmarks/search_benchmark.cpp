@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "search_index.h"
+
+/*
+ * std::lower_bound on a sorted vector<int> versus EytzingerIndex and BTreeIndex from
+ * search_index.h, for sorted vectors from 1K ints (in L1) up to 'max' ints (in RAM).
+ * Each row: nanoseconds per search over a fixed set of random queries, and the time to
+ * build the index once.
+ *
+ * Usage: search_benchmark [max element count, default 64000000] [queries, default 2000000]
+ */
+
+// Nanoseconds per search, best of a few passes over all queries.
+template <typename Search>
+double nsPerSearch(const std::vector<int>& queries, std::uint64_t expected, Search search) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        std::uint64_t checksum = 0;
+        auto start = BenchClock::now();
+        for (int query : queries) {
+            checksum += search(query);
+        }
+        best = std::min(best, secondsSince(start));
+        if (checksum != expected) {
+            std::cerr << "search returned a wrong position" << std::endl;
+            std::exit(1);
+        }
+    }
+    return best * 1e9 / static_cast<double>(queries.size());
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t maxCount = sizeArgument(argc, argv, 1, 64'000'000);
+    std::size_t queryCount = sizeArgument(argc, argv, 2, 2'000'000);
+    std::mt19937_64 random(7);
+
+    for (std::size_t count = 1000; count <= maxCount; count *= 4) {
+        // Even numbers, so half of the queries are misses.
+        std::vector<int> sorted(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = static_cast<int>(random() % (2 * count));
+        }
+        std::uint64_t expected = 0;
+        for (int query : queries) {
+            expected += static_cast<std::uint64_t>(std::lower_bound(sorted.begin(), sorted.end(), query) - sorted.begin());
+        }
+
+        auto start = BenchClock::now();
+        EytzingerIndex<int> eytzinger(sorted);
+        double eytzingerBuild = secondsSince(start);
+        start = BenchClock::now();
+        BTreeIndex<int> btree(sorted);
+        double btreeBuild = secondsSince(start);
+
+        std::cout << count << " ints: std::lower_bound " << nsPerSearch(queries, expected, [&](int query) {
+            return static_cast<std::uint64_t>(std::lower_bound(sorted.begin(), sorted.end(), query) - sorted.begin());
+        }) << " ns, EytzingerIndex " << nsPerSearch(queries, expected, [&](int query) {
+            return static_cast<std::uint64_t>(eytzinger.lowerBound(query));
+        }) << " ns (built in " << eytzingerBuild * 1e3 << " ms), BTreeIndex " << nsPerSearch(queries, expected, [&](int query) {
+            return static_cast<std::uint64_t>(btree.lowerBound(query));
+        }) << " ns (built in " << btreeBuild * 1e3 << " ms)" << std::endl;
+    }
+    return 0;
+}
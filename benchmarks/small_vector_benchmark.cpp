@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <iostream>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "small_vector.h"
+
+/*
+ * Creating, filling, reading and destroying millions of tiny containers, the pattern of
+ * every demo in main.cpp: std::vector, std::stack (std::deque underneath) and
+ * std::stack over std::vector versus small_vector and small_stack from small_vector.h
+ * with 8 elements inline.
+ *
+ * Each row: nanoseconds per container for 'count' containers of 'elements' ints, for 1,
+ * 5 and 8 elements (inline) and 16 (past the inline capacity, so small_vector allocates
+ * too).
+ *
+ * Usage: small_vector_benchmark [container count, default 5000000]
+ */
+
+constexpr std::size_t inlineElements = 8;
+
+// Nanoseconds per container: build one with 'elements' ints, read it back, destroy it.
+template <typename Churn>
+double nsPerContainer(std::size_t count, Churn churn) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        long long checksum = 0;
+        auto start = BenchClock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            checksum += churn(static_cast<int>(i));
+        }
+        best = std::min(best, secondsSince(start));
+        doNotOptimize(checksum);
+    }
+    return best * 1e9 / static_cast<double>(count);
+}
+
+template <typename Vector>
+long long vectorChurn(int seed, std::size_t elements) {
+    Vector values;
+    for (std::size_t i = 0; i < elements; ++i) {
+        values.push_back(seed + static_cast<int>(i));
+    }
+    doNotOptimize(values.data());
+    long long sum = 0;
+    for (int value : values) {
+        sum += value;
+    }
+    return sum;
+}
+
+template <typename Stack>
+long long stackChurn(int seed, std::size_t elements) {
+    Stack stack;
+    for (std::size_t i = 0; i < elements; ++i) {
+        stack.push(seed + static_cast<int>(i));
+    }
+    doNotOptimize(stack.top());
+    long long sum = 0;
+    for (; !stack.empty(); stack.pop()) {
+        sum += stack.top();
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 5'000'000);
+    std::cout << count << " containers each, ns per container (build + read + destroy)" << std::endl;
+    for (std::size_t elements : {std::size_t(1), std::size_t(5), inlineElements, std::size_t(16)}) {
+        std::cout << std::endl << elements << " ints" << std::endl;
+        std::cout << "  std::vector " << nsPerContainer(count, [&](int seed) {
+            return vectorChurn<std::vector<int>>(seed, elements);
+        }) << ", std::vector + reserve " << nsPerContainer(count, [&](int seed) {
+            std::vector<int> values;
+            values.reserve(elements);
+            for (std::size_t i = 0; i < elements; ++i) {
+                values.push_back(seed + static_cast<int>(i));
+            }
+            doNotOptimize(values.data());
+            long long sum = 0;
+            for (int value : values) {
+                sum += value;
+            }
+            return sum;
+        }) << ", small_vector<int, " << inlineElements << "> " << nsPerContainer(count, [&](int seed) {
+            return vectorChurn<small_vector<int, inlineElements>>(seed, elements);
+        }) << std::endl;
+        std::cout << "  std::stack " << nsPerContainer(count, [&](int seed) {
+            return stackChurn<std::stack<int>>(seed, elements);
+        }) << ", std::stack<int, std::vector<int>> " << nsPerContainer(count, [&](int seed) {
+            return stackChurn<std::stack<int, std::vector<int>>>(seed, elements);
+        }) << ", small_stack<int, " << inlineElements << "> " << nsPerContainer(count, [&](int seed) {
+            return stackChurn<small_stack<int, inlineElements>>(seed, elements);
+        }) << std::endl;
+    }
+    return 0;
+}
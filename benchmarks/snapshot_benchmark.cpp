@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "snapshot.h"
+
+/*
+ * Load time of a binary snapshot versus parsing the same data from text.
+ * For each container we time:
+ *   - text:     parse "key value" lines with operator>> into the container
+ *   - snapshot: loadSnapshot() into the container
+ *   - mmap:     open a zero-copy view and touch every entry (no container is built)
+ *
+ * Usage: snapshot_benchmark [element count, default 2000000] [directory, default /tmp]
+ */
+
+template <typename Load>
+double timeIt(Load load) {
+    auto start = BenchClock::now();
+    load();
+    return secondsSince(start);
+}
+
+void reportLine(const std::string& name, double seconds, std::size_t count) {
+    std::cout << "    " << name << seconds * 1000.0 << " ms (" << (count / seconds) / 1e6 << " M entries/s)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 2'000'000);
+    std::string directory = argc > 2 ? argv[2] : "/tmp";
+
+    std::vector<int> numbers(count);
+    std::map<std::string, int> myMap;
+    std::unordered_map<std::string, int> myUnorderedMap;
+    for (std::size_t i = 0; i < count; ++i) {
+        int value = static_cast<int>(i * 2654435761u);
+        numbers[i] = value;
+        std::string key = "key" + std::to_string(value);
+        myMap.emplace(key, static_cast<int>(i));
+        myUnorderedMap.emplace(std::move(key), static_cast<int>(i));
+    }
+
+    std::cout << "Loading " << count << " elements" << std::endl;
+
+    // vector<int>
+    {
+        std::string textPath = directory + "/vector.txt";
+        std::string snapshotPath = directory + "/vector.snap";
+        {
+            std::ofstream text(textPath);
+            for (int value : numbers) {
+                text << value << '\n';
+            }
+        }
+        saveSnapshot(snapshotPath, numbers);
+
+        std::cout << "vector<int>\n";
+        reportLine("text:     ", timeIt([&] {
+            std::ifstream text(textPath);
+            std::vector<int> loaded;
+            int value;
+            while (text >> value) {
+                loaded.push_back(value);
+            }
+            doNotOptimize(loaded.data());
+        }), count);
+        reportLine("snapshot: ", timeIt([&] {
+            auto loaded = loadSnapshot<std::vector<int>>(snapshotPath);
+            doNotOptimize(loaded.data());
+        }), count);
+        reportLine("mmap:     ", timeIt([&] {
+            VectorSnapshotView<int> view(snapshotPath);
+            long long sum = 0;
+            for (int value : view.span()) {
+                sum += value;
+            }
+            doNotOptimize(sum);
+        }), count);
+        std::remove(textPath.c_str());
+        std::remove(snapshotPath.c_str());
+    }
+
+    // map<string, int> and unordered_map<string, int>
+    auto keyValue = [&](const std::string& name, const auto& container) {
+        using Container = std::decay_t<decltype(container)>;
+        std::string textPath = directory + "/" + name + ".txt";
+        std::string snapshotPath = directory + "/" + name + ".snap";
+        {
+            std::ofstream text(textPath);
+            for (const auto& [key, value] : container) {
+                text << key << ' ' << value << '\n';
+            }
+        }
+        saveSnapshot(snapshotPath, container);
+
+        std::cout << name << "<string, int>\n";
+        reportLine("text:     ", timeIt([&] {
+            std::ifstream text(textPath);
+            Container loaded;
+            std::string key;
+            int value;
+            while (text >> key >> value) {
+                loaded.emplace(key, value);
+            }
+            doNotOptimize(loaded.size());
+        }), count);
+        reportLine("snapshot: ", timeIt([&] {
+            auto loaded = loadSnapshot<Container>(snapshotPath);
+            doNotOptimize(loaded.size());
+        }), count);
+        reportLine("mmap:     ", timeIt([&] {
+            MapSnapshotView<std::string, int> view(snapshotPath);
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < view.size(); ++i) {
+                total += view.key(i).size() + static_cast<std::size_t>(view.value(i));
+            }
+            doNotOptimize(total);
+        }), count);
+        std::remove(textPath.c_str());
+        std::remove(snapshotPath.c_str());
+    };
+    keyValue("map", myMap);
+    keyValue("unordered_map", myUnorderedMap);
+
+    return 0;
+}
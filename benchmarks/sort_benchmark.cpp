@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "radix_sort.h"
+
+/*
+ * std::sort versus fastSort from radix_sort.h over a range of sizes
+ * (1000, 10000, ... up to the given maximum) for the usual key types:
+ * 32/64-bit integers, float, double, and std::pair<int, int> sorted by .first
+ * (std::stable_sort versus the radix sort, since both are stable there; the key is
+ * given as the member pointer &Pair::first).
+ *
+ * Every run sorts a fresh copy of the same random input and checks the result.
+ *
+ * Usage: sort_benchmark [max element count, default 10000000]
+ */
+
+template <typename T>
+std::vector<T> randomValues(std::size_t count, std::mt19937_64& random) {
+    std::vector<T> values(count);
+    for (T& value : values) {
+        if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(std::uniform_real_distribution<double>(-1e9, 1e9)(random));
+        } else {
+            value = static_cast<T>(random());
+        }
+    }
+    return values;
+}
+
+// Seconds to sort a copy of 'input' with 'sort', the best of a few repetitions.
+template <typename T, typename Sort, typename Less>
+double timeSort(const std::vector<T>& input, Sort sort, Less less) {
+    std::size_t repetitions = std::max<std::size_t>(1, 1'000'000 / input.size());
+    repetitions = std::min<std::size_t>(repetitions, 20);
+    double best = 1e30;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        std::vector<T> values = input;
+        auto start = BenchClock::now();
+        sort(values);
+        best = std::min(best, secondsSince(start));
+        if (!std::is_sorted(values.begin(), values.end(), less)) {
+            std::cerr << "result is not sorted" << std::endl;
+            std::exit(1);
+        }
+        doNotOptimize(values.data());
+    }
+    return best;
+}
+
+template <typename T>
+void compare(const std::string& name, std::size_t count, std::mt19937_64& random) {
+    std::vector<T> input = randomValues<T>(count, random);
+    auto less = [](const T& a, const T& b) { return a < b; };
+    double stdSeconds = timeSort(input, [](std::vector<T>& v) { std::sort(v.begin(), v.end()); }, less);
+    double fastSeconds = timeSort(input, [](std::vector<T>& v) { fastSort(v.begin(), v.end()); }, less);
+
+    double n = static_cast<double>(count);
+    std::cout << name << " n=" << count << ": std::sort " << stdSeconds * 1e9 / n << " ns/element, fastSort "
+              << fastSeconds * 1e9 / n << " ns/element, speedup " << stdSeconds / fastSeconds << "x" << std::endl;
+}
+
+void comparePairs(std::size_t count, std::mt19937_64& random) {
+    using Pair = std::pair<int, int>;
+    std::vector<Pair> input(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        input[i] = {static_cast<int>(random()), static_cast<int>(i)};
+    }
+    auto less = [](const Pair& a, const Pair& b) { return a.first < b.first; };
+    double stdSeconds = timeSort(input, [&](std::vector<Pair>& v) { std::stable_sort(v.begin(), v.end(), less); }, less);
+    double fastSeconds = timeSort(input, [&](std::vector<Pair>& v) { fastSort(v.begin(), v.end(), &Pair::first); }, less);
+
+    double n = static_cast<double>(count);
+    std::cout << "pair<int, int> by .first n=" << count << ": std::stable_sort " << stdSeconds * 1e9 / n
+              << " ns/element, fastSort " << fastSeconds * 1e9 / n << " ns/element, speedup "
+              << stdSeconds / fastSeconds << "x" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t maxCount = sizeArgument(argc, argv, 1, 10'000'000);
+    std::mt19937_64 random(7);
+
+    for (std::size_t count = 1000; count <= maxCount; count *= 10) {
+        compare<std::uint32_t>("uint32_t", count, random);
+        compare<int>("int", count, random);
+        compare<std::int64_t>("int64_t", count, random);
+        compare<float>("float", count, random);
+        compare<double>("double", count, random);
+        comparePairs(count, random);
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "bench_util.h"
+#include "spsc_queue.h"
+
+/*
+ * Passing ints from a producer thread to a consumer thread: a std::queue behind a
+ * std::mutex versus SpscQueue from spsc_queue.h.
+ *
+ * throughput: the producer pushes 'count' ints as fast as it can, the consumer pops and
+ *             sums them. SpscQueue with single push / pop and with batches of 64.
+ * latency:    ping-pong between two threads over a pair of queues; the time of one round
+ *             trip, i.e. two hand-overs.
+ *
+ * The two threads are pinned to CPUs 0 and 1 when the machine has two (Linux only).
+ * On a single CPU the numbers mostly measure the scheduler.
+ *
+ * Usage: spsc_benchmark [element count, default 20000000] [round trips, default 1000000]
+ */
+
+constexpr std::size_t queueCapacity = 1 << 14;
+constexpr std::size_t batchSize = 64;
+
+bool canPin() {
+#if defined(__linux__)
+    return std::thread::hardware_concurrency() >= 2;
+#else
+    return false;
+#endif
+}
+
+void pinToCpu(std::thread& thread, int cpu) {
+#if defined(__linux__)
+    if (canPin()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    }
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+// A std::queue with a lock around every operation.
+struct MutexQueue {
+    std::mutex mutex;
+    std::queue<int> queue;
+
+    void push(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(value);
+    }
+
+    bool tryPop(int& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return false;
+        }
+        out = queue.front();
+        queue.pop();
+        return true;
+    }
+};
+
+// Runs 'producer' and 'consumer' on two (pinned) threads; seconds until both are done.
+template <typename Producer, typename Consumer>
+double runPair(Producer producer, Consumer consumer) {
+    auto start = BenchClock::now();
+    std::thread consumerThread(consumer);
+    std::thread producerThread(producer);
+    pinToCpu(consumerThread, 0);
+    pinToCpu(producerThread, 1);
+    producerThread.join();
+    consumerThread.join();
+    return secondsSince(start);
+}
+
+void report(const std::string& name, std::size_t count, double seconds, std::uint64_t sum, std::uint64_t expected) {
+    if (sum != expected) {
+        std::cerr << name << ": lost or duplicated elements" << std::endl;
+        std::exit(1);
+    }
+    std::cout << "  " << name << ": " << seconds * 1e3 << " ms, " << static_cast<double>(count) / seconds / 1e6
+              << " M elements/s" << std::endl;
+}
+
+void throughput(std::size_t count) {
+    std::uint64_t expected = static_cast<std::uint64_t>(count) * (count - 1) / 2;
+    std::cout << "throughput, " << count << " ints" << std::endl;
+    {
+        MutexQueue queue;
+        std::uint64_t sum = 0;
+        double seconds = runPair([&] {
+            for (std::size_t i = 0; i < count; ++i) {
+                queue.push(static_cast<int>(i));
+            }
+        }, [&] {
+            int value;
+            for (std::size_t received = 0; received < count;) {
+                if (queue.tryPop(value)) {
+                    sum += static_cast<std::uint64_t>(value);
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        report("mutex + std::queue", count, seconds, sum, expected);
+    }
+    {
+        SpscQueue<int> queue(queueCapacity);
+        std::uint64_t sum = 0;
+        double seconds = runPair([&] {
+            for (std::size_t i = 0; i < count; ++i) {
+                queue.push(static_cast<int>(i));
+            }
+        }, [&] {
+            for (std::size_t received = 0; received < count; ++received) {
+                sum += static_cast<std::uint64_t>(queue.pop());
+            }
+        });
+        report("SpscQueue push / pop", count, seconds, sum, expected);
+    }
+    {
+        SpscQueue<int> queue(queueCapacity);
+        std::uint64_t sum = 0;
+        double seconds = runPair([&] {
+            int values[batchSize];
+            for (std::size_t sent = 0; sent < count;) {
+                std::size_t n = std::min(batchSize, count - sent);
+                for (std::size_t i = 0; i < n; ++i) {
+                    values[i] = static_cast<int>(sent + i);
+                }
+                for (std::size_t done = 0; done < n;) {
+                    std::size_t pushed = queue.pushBatch(values + done, n - done);
+                    if (pushed == 0) {
+                        std::this_thread::yield();
+                    }
+                    done += pushed;
+                }
+                sent += n;
+            }
+        }, [&] {
+            int values[batchSize];
+            for (std::size_t received = 0; received < count;) {
+                std::size_t n = queue.popBatch(values, batchSize);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += static_cast<std::uint64_t>(values[i]);
+                }
+                received += n;
+            }
+        });
+        report("SpscQueue batches of " + std::to_string(batchSize), count, seconds, sum, expected);
+    }
+}
+
+// Round trip: 'ping' carries a value to the other thread, which sends it back on 'pong'.
+template <typename Queue, typename Send, typename Receive>
+void roundTrips(const std::string& name, std::size_t trips, Queue& ping, Queue& pong, Send send, Receive receive) {
+    std::uint64_t sum = 0;
+    double seconds = runPair([&] {
+        for (std::size_t i = 0; i < trips; ++i) {
+            send(ping, static_cast<int>(i));
+            sum += static_cast<std::uint64_t>(receive(pong));
+        }
+    }, [&] {
+        for (std::size_t i = 0; i < trips; ++i) {
+            send(pong, receive(ping));
+        }
+    });
+    if (sum != static_cast<std::uint64_t>(trips) * (trips - 1) / 2) {
+        std::cerr << name << ": wrong value returned" << std::endl;
+        std::exit(1);
+    }
+    std::cout << "  " << name << ": " << seconds * 1e9 / static_cast<double>(trips) << " ns per round trip" << std::endl;
+}
+
+void latency(std::size_t trips) {
+    std::cout << "latency, " << trips << " round trips" << std::endl;
+    {
+        MutexQueue ping;
+        MutexQueue pong;
+        roundTrips("mutex + std::queue", trips, ping, pong, [](MutexQueue& queue, int value) { queue.push(value); },
+                   [](MutexQueue& queue) {
+                       int value;
+                       while (!queue.tryPop(value)) {
+                           std::this_thread::yield();
+                       }
+                       return value;
+                   });
+    }
+    {
+        SpscQueue<int> ping(queueCapacity);
+        SpscQueue<int> pong(queueCapacity);
+        roundTrips("SpscQueue", trips, ping, pong, [](SpscQueue<int>& queue, int value) { queue.push(value); },
+                   [](SpscQueue<int>& queue) { return queue.pop(); });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 20'000'000);
+    std::size_t trips = sizeArgument(argc, argv, 2, 1'000'000);
+    std::cout << (canPin() ? "threads pinned to CPUs 0 and 1" : "threads not pinned") << std::endl << std::endl;
+    throughput(count);
+    std::cout << std::endl;
+    latency(trips);
+    return 0;
+}
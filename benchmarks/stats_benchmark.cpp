@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "statistics.h"
+
+/*
+ * Separate algorithm passes versus the one-scan statistics / parallelStatistics from
+ * statistics.h, for int and double vectors much larger than the caches.
+ *
+ * separate passes: std::min_element, std::max_element, std::count, std::accumulate and a
+ *                  second pass for the variance (five scans of memory).
+ * statistics:      on each instruction set the CPU has.
+ * parallel:        parallelStatistics on ThreadPools of 1, 2, 4, ... hardware threads.
+ *
+ * Usage: stats_benchmark [element count, default 100000000]
+ */
+
+template <typename Run>
+void row(const std::string& name, std::size_t bytes, Run run) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto start = BenchClock::now();
+        run();
+        best = std::min(best, secondsSince(start));
+    }
+    std::cout << "  " << name << ": " << best * 1e3 << " ms, " << static_cast<double>(bytes) / best / 1e9 << " GB/s" << std::endl;
+}
+
+template <typename T>
+void compare(const std::string& name, const std::vector<T>& values, T counted) {
+    std::size_t bytes = values.size() * sizeof(T);
+    std::cout << values.size() << " " << name << std::endl;
+    row("separate passes", bytes, [&] {
+        doNotOptimize(*std::min_element(values.begin(), values.end()));
+        doNotOptimize(*std::max_element(values.begin(), values.end()));
+        doNotOptimize(std::count(values.begin(), values.end(), counted));
+        double mean = static_cast<double>(std::accumulate(values.begin(), values.end(), SumType<T>(0))) /
+                      static_cast<double>(values.size());
+        double squares = 0;
+        for (T value : values) {
+            squares += (static_cast<double>(value) - mean) * (static_cast<double>(value) - mean);
+        }
+        doNotOptimize(squares / static_cast<double>(values.size()));
+    });
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        if (usableSimdLevel(level) != level) {
+            continue;
+        }
+        row(std::string("statistics/") + simdLevelName(level), bytes, [&] {
+            doNotOptimize(statistics(values, counted, level).variance);
+        });
+    }
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, hardware)) {
+        ThreadPool pool(threads);
+        row("parallelStatistics, " + std::to_string(threads) + " thread(s)", bytes, [&] {
+            doNotOptimize(parallelStatistics(pool, values.data(), values.size(), counted).variance);
+        });
+        if (threads == hardware) {
+            break;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 100'000'000);
+    std::mt19937_64 random(7);
+
+    std::vector<int> ints(count);
+    for (int& value : ints) {
+        value = static_cast<int>(random() % 1'000'000);
+    }
+    compare("ints", ints, 2);
+
+    std::vector<double> doubles(count / 2);
+    std::normal_distribution<double> normal(100.0, 15.0);
+    for (double& value : doubles) {
+        value = normal(random);
+    }
+    std::cout << std::endl;
+    compare("doubles", doubles, 100.0);
+    return 0;
+}
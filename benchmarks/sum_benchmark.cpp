@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "parallel_sum.h"
+
+#if defined(STL_PARALLEL_STL)
+#include <execution>
+#endif
+
+/*
+ * std::accumulate versus safeSum / parallelSum from parallel_sum.h.
+ *
+ * int:    a vector of large ints, so std::accumulate(..., 0) overflows; every row shows the
+ *         time and whether the result is right.
+ * double: values of very different magnitudes; every row shows the time and the error
+ *         relative to a long double Kahan sum.
+ * parallelSum runs on ThreadPools of 1, 2, 4, ... up to the hardware thread count,
+ * then on its default backend; std::reduce(par_unseq) is added when built with TBB.
+ *
+ * Usage: sum_benchmark [element count, default 100000000]
+ */
+
+// Best time of a few repetitions, with the result of the last one.
+template <typename Run>
+auto timeBest(Run run) {
+    double best = 1e30;
+    decltype(run()) result{};
+    for (int r = 0; r < 3; ++r) {
+        auto start = BenchClock::now();
+        result = run();
+        best = std::min(best, secondsSince(start));
+    }
+    return std::make_pair(best, result);
+}
+
+template <typename Run>
+void row(const std::string& name, std::size_t count, std::size_t bytes, long long expected, Run run) {
+    auto [seconds, result] = timeBest(run);
+    std::cout << "  " << name << ": " << seconds * 1e9 / static_cast<double>(count) << " ns/element, "
+              << static_cast<double>(bytes) / seconds / 1e9 << " GB/s, "
+              << (static_cast<long long>(result) == expected ? "correct" : "WRONG") << std::endl;
+}
+
+template <typename Run>
+void row(const std::string& name, std::size_t count, std::size_t bytes, double expected, Run run) {
+    auto [seconds, result] = timeBest(run);
+    std::cout << "  " << name << ": " << seconds * 1e9 / static_cast<double>(count) << " ns/element, "
+              << static_cast<double>(bytes) / seconds / 1e9 << " GB/s, relative error "
+              << std::abs((static_cast<double>(result) - expected) / expected) << std::endl;
+}
+
+std::vector<std::size_t> threadCounts() {
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> counts;
+    for (std::size_t threads = 1; threads < hardware; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+    return counts;
+}
+
+template <typename T, typename Expected>
+void compareParallel(const std::string& name, const std::vector<T>& values, Expected expected, Summation method) {
+    std::size_t bytes = values.size() * sizeof(T);
+    for (std::size_t threads : threadCounts()) {
+        ThreadPool pool(threads);
+        row(name + ", " + std::to_string(threads) + " thread(s)", values.size(), bytes, expected,
+            [&] { return parallelSum(pool, values.data(), values.size(), method); });
+    }
+    row(name + ", default backend", values.size(), bytes, expected,
+        [&] { return parallelSum(values.data(), values.size(), method); });
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count = sizeArgument(argc, argv, 1, 100'000'000);
+    std::mt19937_64 random(7);
+
+    std::vector<int> ints(count);
+    for (int& value : ints) {
+        value = static_cast<int>(random() % 1'000'000'000);
+    }
+    long long exact = 0;
+    for (int value : ints) {
+        exact += value;
+    }
+    std::size_t intBytes = count * sizeof(int);
+    std::cout << count << " ints" << std::endl;
+    row("std::accumulate(..., 0)", count, intBytes, exact,
+        [&] { return std::accumulate(ints.begin(), ints.end(), 0); });
+    row("std::accumulate(..., 0LL)", count, intBytes, exact,
+        [&] { return std::accumulate(ints.begin(), ints.end(), 0LL); });
+    row("safeSum", count, intBytes, exact, [&] { return safeSum(ints); });
+    compareParallel("parallelSum", ints, exact, Summation::Pairwise);
+#if defined(STL_PARALLEL_STL)
+    row("std::reduce(par_unseq, ..., 0LL)", count, intBytes, exact,
+        [&] { return std::reduce(std::execution::par_unseq, ints.begin(), ints.end(), 0LL); });
+#endif
+
+    std::vector<double> doubles(count);
+    std::uniform_real_distribution<double> mantissa(1.0, 2.0);
+    for (double& value : doubles) {
+        value = mantissa(random) * std::pow(10.0, static_cast<double>(random() % 20) - 4);
+    }
+    sum_detail::Compensated<long double> reference;
+    for (double value : doubles) {
+        reference.add(value);
+    }
+    double expected = static_cast<double>(reference.value());
+    std::size_t doubleBytes = count * sizeof(double);
+    std::cout << std::endl << count << " doubles" << std::endl;
+    row("std::accumulate", count, doubleBytes, expected,
+        [&] { return std::accumulate(doubles.begin(), doubles.end(), 0.0); });
+    row("safeSum pairwise", count, doubleBytes, expected, [&] { return safeSum(doubles); });
+    row("safeSum Kahan", count, doubleBytes, expected, [&] { return safeSum(doubles, Summation::Kahan); });
+    compareParallel("parallelSum pairwise", doubles, expected, Summation::Pairwise);
+    compareParallel("parallelSum Kahan", doubles, expected, Summation::Kahan);
+#if defined(STL_PARALLEL_STL)
+    row("std::reduce(par_unseq)", count, doubleBytes, expected,
+        [&] { return std::reduce(std::execution::par_unseq, doubles.begin(), doubles.end(), 0.0); });
+#endif
+    return 0;
+}
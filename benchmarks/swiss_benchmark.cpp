@@ -0,0 +1,108 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "swiss_table.h"
+
+/*
+ * swiss_map (swiss_table.h) versus std::unordered_map at several load factors.
+ *
+ * The swiss_map is sized to 'capacity' slots up front and filled to 50%, 75% and
+ * 87.5% (its maximum) of that; std::unordered_map gets the same keys with reserve().
+ * For each fill level we time insert, lookups that hit, lookups that miss, and
+ * erasing half of the keys, for int and std::string keys.
+ *
+ * Usage: swiss_benchmark [capacity, rounded up to a power of two, default 1048576]
+ */
+
+constexpr std::size_t lookups = 1'000'000;
+
+template <typename Key>
+Key makeKey(std::uint64_t value) {
+    if constexpr (std::is_same_v<Key, std::string>) {
+        return "key" + std::to_string(value);
+    } else {
+        return static_cast<Key>(value);
+    }
+}
+
+template <typename Map, typename Key>
+void run(const std::string& name, const std::vector<Key>& keys,
+         const std::vector<Key>& hits, const std::vector<Key>& misses) {
+    // Both tables are sized up front; for swiss_map this gives exactly 'capacity' slots.
+    Map map;
+    map.reserve(keys.size());
+
+    auto start = BenchClock::now();
+    for (const auto& key : keys) {
+        map.emplace(key, 1);
+    }
+    double insertNs = secondsSince(start) * 1e9 / static_cast<double>(keys.size());
+
+    start = BenchClock::now();
+    std::size_t found = 0;
+    for (const auto& key : hits) {
+        found += map.find(key) != map.end();
+    }
+    doNotOptimize(found);
+    double hitNs = secondsSince(start) * 1e9 / static_cast<double>(hits.size());
+
+    start = BenchClock::now();
+    for (const auto& key : misses) {
+        found += map.find(key) != map.end();
+    }
+    doNotOptimize(found);
+    double missNs = secondsSince(start) * 1e9 / static_cast<double>(misses.size());
+
+    std::size_t erases = keys.size() / 2;
+    start = BenchClock::now();
+    for (std::size_t i = 0; i < erases; ++i) {
+        map.erase(keys[i]);
+    }
+    double eraseNs = secondsSince(start) * 1e9 / static_cast<double>(erases);
+
+    std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(1)
+              << " insert " << std::setw(7) << insertNs << " ns   hit " << std::setw(7) << hitNs
+              << " ns   miss " << std::setw(7) << missNs << " ns   erase " << std::setw(7) << eraseNs << " ns"
+              << std::endl;
+}
+
+template <typename Key>
+void sweep(const std::string& keyName, std::size_t capacity) {
+    std::mt19937_64 random(3);
+    for (double load : {0.5, 0.75, 0.875}) {
+        auto count = static_cast<std::size_t>(static_cast<double>(capacity) * load);
+        std::vector<Key> keys;
+        keys.reserve(count);
+        // Even values are stored, odd values are guaranteed misses.
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back(makeKey<Key>(random() & ~1ULL));
+        }
+        std::vector<Key> hits;
+        std::vector<Key> misses;
+        std::uniform_int_distribution<std::size_t> position(0, count - 1);
+        for (std::size_t i = 0; i < lookups; ++i) {
+            hits.push_back(keys[position(random)]);
+            misses.push_back(makeKey<Key>(random() | 1ULL));
+        }
+
+        std::cout << std::defaultfloat << keyName << " keys, load factor " << load << " (" << count << " elements)" << std::endl;
+        run<std::unordered_map<Key, int>>("std::unordered_map<" + keyName + ", int>", keys, hits, misses);
+        run<swiss_map<Key, int>>("swiss_map<" + keyName + ", int>", keys, hits, misses);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t capacity = 16;
+    std::size_t wanted = sizeArgument(argc, argv, 1, 1 << 20);
+    while (capacity < wanted) {
+        capacity *= 2;
+    }
+    sweep<std::uint64_t>("uint64_t", capacity);
+    sweep<std::string>("std::string", capacity);
+    return 0;
+}
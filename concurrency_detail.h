@@ -0,0 +1,48 @@
+#ifndef CONCURRENCY_DETAIL_H
+#define CONCURRENCY_DETAIL_H
+
+#include <cstddef>
+#include <thread>
+
+/*
+ * Small pieces shared by the concurrent containers (spsc_queue.h, mpmc_queue.h,
+ * concurrent_map.h): the cache line size used to keep independently written data on
+ * separate lines, power-of-two rounding for ring sizes, and the spin-then-yield wait.
+ */
+
+namespace concurrency_detail {
+
+// Align data written by different threads to this, so they do not share a cache line.
+inline constexpr std::size_t cacheLine = 64;
+// Spins before a waiting push / pop starts yielding the CPU.
+inline constexpr int spinsBeforeYield = 64;
+
+inline std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+inline void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Waits for 'ready' to become true: spinning first, yielding afterwards.
+template <typename Ready>
+void waitUntil(Ready ready) {
+    for (int spins = 0; !ready(); ++spins) {
+        if (spins < spinsBeforeYield) {
+            pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace concurrency_detail
+
+#endif // CONCURRENCY_DETAIL_H
@@ -0,0 +1,195 @@
+#ifndef CONCURRENT_MAP_H
+#define CONCURRENT_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+#include "concurrency_detail.h"
+#include "swiss_table.h"
+
+/*
+ * ConcurrentHashMap: a hash map that many threads can read and write at once, where the
+ * unordered_map section of main.cpp would need one std::mutex around the whole map (and
+ * so lets only one thread in at a time, readers included).
+ *
+ * The map is split into a power-of-two number of shards, each a swiss_map (swiss_table.h)
+ * with its own std::shared_mutex. The top bits of a key's hash pick the shard (the table
+ * inside uses the lower ones), so operations on keys in different shards never wait for
+ * each other, and lookups in the same shard share the lock. Every shard sits on its own
+ * cache lines, so locking one does not slow down threads using its neighbours.
+ *
+ * With enough shards (the default is 8 per hardware thread, at least 16) writers rarely
+ * meet. Readers of one shard still all write its lock word, so a read-mostly workload on
+ * a few very hot keys is limited by that cache line; spread hot keys or use more shards.
+ *
+ * Because other threads may change or erase an element at any time, the interface does
+ * not hand out iterators or references: find() returns a copy, and visit() / update() run
+ * a function on the element while its shard is locked (shared / exclusive). Do not call
+ * back into the map from those functions (deadlock on the same shard). size() and
+ * forEach() lock one shard at a time, so they see a consistent view of each shard but
+ * not of the whole map while writers are active.
+ */
+
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+
+    // 'shards' is rounded up to a power of two.
+    explicit ConcurrentHashMap(std::size_t shards = defaultShardCount())
+        : shardBits_(bitsFor(shards)), shards_(new Shard[std::size_t(1) << shardBits_]) {}
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    static std::size_t defaultShardCount() {
+        return std::max<std::size_t>(16, std::size_t(8) * std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    std::size_t shardCount() const noexcept { return std::size_t(1) << shardBits_; }
+
+    // Inserts (key, mapped built from 'args') if the key is new. False if it was there already.
+    template <typename... Args>
+    bool emplace(const Key& key, Args&&... args) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.map.try_emplace(key, std::forward<Args>(args)...).second;
+    }
+
+    bool insert(const Key& key, const T& value) { return emplace(key, value); }
+
+    // Inserts or overwrites. True if the key was new.
+    template <typename V>
+    bool insertOrAssign(const Key& key, V&& value) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        auto [it, inserted] = shard.map.try_emplace(key, std::forward<V>(value));
+        if (!inserted) {
+            it->second = std::forward<V>(value);
+        }
+        return inserted;
+    }
+
+    // Runs update(mapped) under the shard's exclusive lock, inserting 'initial' first if the
+    // key is new (e.g. counters: insertOrUpdate(word, 0, [](int& n) { ++n; })).
+    template <typename V, typename Update>
+    void insertOrUpdate(const Key& key, V&& initial, Update update) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        update(shard.map.try_emplace(key, std::forward<V>(initial)).first->second);
+    }
+
+    // Runs update(mapped) under the shard's exclusive lock. False if the key is not there.
+    template <typename Update>
+    bool update(const Key& key, Update update) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        update(it->second);
+        return true;
+    }
+
+    // Runs visit(const mapped&) under the shard's shared lock. False if the key is not there.
+    template <typename Visit>
+    bool visit(const Key& key, Visit visit) const {
+        const Shard& shard = shardFor(key);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        visit(it->second);
+        return true;
+    }
+
+    // A copy of the mapped value, or nothing.
+    std::optional<T> find(const Key& key) const {
+        std::optional<T> result;
+        visit(key, [&](const T& value) { result = value; });
+        return result;
+    }
+
+    bool contains(const Key& key) const {
+        const Shard& shard = shardFor(key);
+        std::shared_lock lock(shard.mutex);
+        return shard.map.contains(key);
+    }
+
+    // True if the key was there.
+    bool erase(const Key& key) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.map.erase(key) > 0;
+    }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < shardCount(); ++i) {
+            std::shared_lock lock(shards_[i].mutex);
+            total += shards_[i].map.size();
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        for (std::size_t i = 0; i < shardCount(); ++i) {
+            std::unique_lock lock(shards_[i].mutex);
+            shards_[i].map.clear();
+        }
+    }
+
+    // Calls f(key, mapped) for every element, shard by shard under each shard's shared lock.
+    template <typename F>
+    void forEach(F f) const {
+        for (std::size_t i = 0; i < shardCount(); ++i) {
+            std::shared_lock lock(shards_[i].mutex);
+            for (const auto& [key, value] : shards_[i].map) {
+                f(key, value);
+            }
+        }
+    }
+
+private:
+    struct alignas(concurrency_detail::cacheLine) Shard {
+        mutable std::shared_mutex mutex;
+        swiss_map<Key, T, Hash, KeyEqual> map;
+    };
+
+    static unsigned bitsFor(std::size_t shards) {
+        unsigned bits = 0;
+        while ((std::size_t(1) << bits) < shards) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    std::size_t shardIndex(const Key& key) const {
+        if (shardBits_ == 0) {
+            return 0;
+        }
+        // Top bits: swiss_map indexes its groups from the low bits of the same mixed hash.
+        return swiss_detail::mixHash(hash_(key)) >> (sizeof(std::size_t) * 8 - shardBits_);
+    }
+
+    Shard& shardFor(const Key& key) { return shards_[shardIndex(key)]; }
+    const Shard& shardFor(const Key& key) const { return shards_[shardIndex(key)]; }
+
+    const unsigned shardBits_;
+    const std::unique_ptr<Shard[]> shards_;
+    [[no_unique_address]] Hash hash_;
+};
+
+#endif // CONCURRENT_MAP_H
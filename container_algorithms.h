@@ -0,0 +1,141 @@
+#ifndef CONTAINER_ALGORITHMS_H
+#define CONTAINER_ALGORITHMS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "count_values.h"
+#include "radix_sort.h"
+
+/*
+ * sort / find / count / reverse for a whole container, picking at compile time the way
+ * that suits the container, so the same call works on every section of main.cpp.
+ *
+ * containerSort     random access:  fastSort (radix_sort.h) or std::sort with 'comp'.
+ *                   std::list / std::forward_list (std::sort does not compile on them):
+ *                   small trivially copyable elements are gathered into a vector, sorted
+ *                   there (contiguous, no pointer chasing, radix sort for numbers) and
+ *                   written back in list order; the nodes stay where they are. Other
+ *                   elements use the member sort(), which relinks nodes and never copies
+ *                   (sorting iterators in a vector and splicing the nodes back in order
+ *                   measured no faster for std::list<std::string>).
+ *                   For lists the result is stable either way, as with list::sort.
+ * containerFind     containers with a member find (set, map, unordered_*, flat_*, swiss_*):
+ *                   that, O(log n) or O(1), instead of a linear std::find.
+ *                   Everything else: std::find.
+ * containerCount    member count for the same containers; SIMD countEqual
+ *                   (count_values.h) for contiguous integer ranges; std::count otherwise.
+ * containerReverse  list / forward_list: the member reverse(), which relinks nodes instead
+ *                   of swapping values through two iterators. std::reverse otherwise.
+ *
+ * containerFind and containerCount on a map take a key, like its members do.
+ */
+
+// Lists gather elements up to this size into a vector to sort them.
+inline constexpr std::size_t gatherSortMaxElementSize = 16;
+
+namespace container_detail {
+
+template <typename C>
+concept HasMemberSort = requires(C& c) { c.sort(); };
+
+template <typename C, typename Compare>
+concept HasMemberSortWith = requires(C& c, Compare comp) { c.sort(comp); };
+
+template <typename C, typename V>
+concept HasMemberFind = requires(C& c, const V& value) {
+    { c.find(value) } -> std::same_as<decltype(std::ranges::begin(c))>;
+};
+
+template <typename C, typename V>
+concept HasMemberCount = requires(const C& c, const V& value) { c.count(value); };
+
+template <typename C>
+concept HasMemberReverse = requires(C& c) { c.reverse(); };
+
+template <typename C>
+using ValueOf = std::ranges::range_value_t<C>;
+
+// 'Compare' is the default ascending order (what sort() without arguments does).
+template <typename Compare, typename T>
+inline constexpr bool isPlainLess = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+template <typename>
+inline constexpr bool alwaysFalse = false;
+
+template <typename C>
+inline constexpr bool gatherToSort = std::is_trivially_copyable_v<ValueOf<C>> &&
+                                     sizeof(ValueOf<C>) <= gatherSortMaxElementSize;
+
+template <typename It, typename Compare>
+void sortRandomAccess(It first, It last, Compare comp) {
+    if constexpr (RadixKey<std::iter_value_t<It>> && isPlainLess<Compare, std::iter_value_t<It>>) {
+        fastSort(first, last);
+    } else {
+        std::sort(first, last, comp);
+    }
+}
+
+} // namespace container_detail
+
+template <std::ranges::forward_range C, typename Compare = std::less<>>
+void containerSort(C& container, Compare comp = {}) {
+    using namespace container_detail;
+    if constexpr (std::ranges::random_access_range<C>) {
+        sortRandomAccess(std::ranges::begin(container), std::ranges::end(container), comp);
+    } else if constexpr (gatherToSort<C> && std::ranges::output_range<C, ValueOf<C>>) {
+        std::vector<ValueOf<C>> values(std::ranges::begin(container), std::ranges::end(container));
+        if constexpr (RadixKey<ValueOf<C>> && isPlainLess<Compare, ValueOf<C>>) {
+            // Radix sort is stable; below its threshold std::sort is used, equal numbers being interchangeable.
+            fastSort(values.begin(), values.end());
+        } else {
+            std::stable_sort(values.begin(), values.end(), comp);
+        }
+        std::ranges::copy(values, std::ranges::begin(container));
+    } else if constexpr (HasMemberSortWith<C, Compare>) {
+        container.sort(comp);
+    } else if constexpr (HasMemberSort<C> && isPlainLess<Compare, ValueOf<C>>) {
+        container.sort();
+    } else {
+        static_assert(alwaysFalse<C>, "containerSort: no way to sort this container with this comparison");
+    }
+}
+
+template <std::ranges::input_range C, typename V>
+auto containerFind(C& container, const V& value) {
+    if constexpr (container_detail::HasMemberFind<C, V>) {
+        return container.find(value);
+    } else {
+        return std::ranges::find(container, value);
+    }
+}
+
+template <std::ranges::input_range C, typename V>
+std::size_t containerCount(const C& container, const V& value) {
+    using T = container_detail::ValueOf<C>;
+    if constexpr (container_detail::HasMemberCount<C, V>) {
+        return static_cast<std::size_t>(container.count(value));
+    } else if constexpr (std::ranges::contiguous_range<const C> && CountableInteger<T> && std::is_convertible_v<V, T>) {
+        return countEqual(container, static_cast<T>(value));
+    } else {
+        return static_cast<std::size_t>(std::ranges::count(container, value));
+    }
+}
+
+template <std::ranges::bidirectional_range C>
+requires(!container_detail::HasMemberReverse<C>)
+void containerReverse(C& container) {
+    std::ranges::reverse(container);
+}
+
+template <container_detail::HasMemberReverse C>
+void containerReverse(C& container) {
+    container.reverse();
+}
+
+#endif // CONTAINER_ALGORITHMS_H
@@ -0,0 +1,256 @@
+#ifndef COUNT_VALUES_H
+#define COUNT_VALUES_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "simd_dispatch.h"
+
+/*
+ * Counting values without one scalar loop per value.
+ *
+ * countEqual  std::count for integer ranges: compares a whole SSE4.1 / AVX2 register
+ *             against the value at once, turns the result into a bit mask (movemask)
+ *             and adds its popcount. The kernel is picked at run time (simd_dispatch.h).
+ * histogram   counts every value of a small domain [low, high] in one pass. Four
+ *             interleaved count tables keep runs of equal values from waiting on the
+ *             same counter.
+ * countEach   the counts of K different values. Uses the histogram (one scan) when the
+ *             values are close together and there are enough of them, otherwise K countEqual scans.
+ */
+
+// countEach switches to the histogram from this many values on; below it, K vectorized
+// scans are still faster than one scalar histogram pass.
+inline constexpr std::size_t countEachHistogramMinValues = 8;
+// ... and only when the values span at most this many integers.
+inline constexpr std::size_t countEachHistogramMaxDomain = std::size_t(1) << 16;
+
+template <typename T>
+concept CountableInteger = std::integral<T> && !std::same_as<T, bool>;
+
+namespace count_detail {
+
+template <typename T>
+std::size_t countEqualScalar(const T* data, std::size_t count, T value) {
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        matches += data[i] == value;
+    }
+    return matches;
+}
+
+#if defined(STL_SIMD_X86)
+
+// Compare + movemask: one bit per matching byte, so a match of a T sets sizeof(T) bits.
+
+template <std::size_t Size>
+STL_TARGET_SSE41 __m128i equalSse41(__m128i a, __m128i b) {
+    if constexpr (Size == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (Size == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else if constexpr (Size == 4) {
+        return _mm_cmpeq_epi32(a, b);
+    } else {
+        return _mm_cmpeq_epi64(a, b);
+    }
+}
+
+template <typename T>
+STL_TARGET_SSE41 __m128i broadcastSse41(T value) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_set1_epi16(static_cast<short>(value));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm_set1_epi32(static_cast<int>(value));
+    } else {
+        return _mm_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+template <std::size_t Size>
+STL_TARGET_AVX2 __m256i equalAvx2(__m256i a, __m256i b) {
+    if constexpr (Size == 1) {
+        return _mm256_cmpeq_epi8(a, b);
+    } else if constexpr (Size == 2) {
+        return _mm256_cmpeq_epi16(a, b);
+    } else if constexpr (Size == 4) {
+        return _mm256_cmpeq_epi32(a, b);
+    } else {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+}
+
+template <typename T>
+STL_TARGET_AVX2 __m256i broadcastAvx2(T value) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    } else {
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+template <typename T>
+STL_TARGET_SSE41 std::size_t countEqualSse41(const T* data, std::size_t count, T value) {
+    constexpr std::size_t perRegister = 16 / sizeof(T);
+    const __m128i needle = broadcastSse41(value);
+    std::size_t matchedBytes = 0;
+    std::size_t i = 0;
+    for (; i + 4 * perRegister <= count; i += 4 * perRegister) {
+        const auto* p = reinterpret_cast<const __m128i*>(data + i);
+        auto m0 = static_cast<unsigned>(_mm_movemask_epi8(equalSse41<sizeof(T)>(_mm_loadu_si128(p), needle)));
+        auto m1 = static_cast<unsigned>(_mm_movemask_epi8(equalSse41<sizeof(T)>(_mm_loadu_si128(p + 1), needle)));
+        auto m2 = static_cast<unsigned>(_mm_movemask_epi8(equalSse41<sizeof(T)>(_mm_loadu_si128(p + 2), needle)));
+        auto m3 = static_cast<unsigned>(_mm_movemask_epi8(equalSse41<sizeof(T)>(_mm_loadu_si128(p + 3), needle)));
+        // Four 16-bit masks fit in one 64-bit word: a single popcount for the four registers.
+        std::uint64_t masks = m0 | (m1 << 16) | (std::uint64_t(m2) << 32) | (std::uint64_t(m3) << 48);
+        matchedBytes += static_cast<std::size_t>(std::popcount(masks));
+    }
+    for (; i + perRegister <= count; i += perRegister) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        matchedBytes += static_cast<std::size_t>(
+            std::popcount(static_cast<unsigned>(_mm_movemask_epi8(equalSse41<sizeof(T)>(values, needle)))));
+    }
+    return matchedBytes / sizeof(T) + countEqualScalar(data + i, count - i, value);
+}
+
+template <typename T>
+STL_TARGET_AVX2 std::size_t countEqualAvx2(const T* data, std::size_t count, T value) {
+    constexpr std::size_t perRegister = 32 / sizeof(T);
+    const __m256i needle = broadcastAvx2(value);
+    std::size_t matchedBytes = 0;
+    std::size_t i = 0;
+    for (; i + 2 * perRegister <= count; i += 2 * perRegister) {
+        const auto* p = reinterpret_cast<const __m256i*>(data + i);
+        auto m0 = static_cast<std::uint32_t>(_mm256_movemask_epi8(equalAvx2<sizeof(T)>(_mm256_loadu_si256(p), needle)));
+        auto m1 = static_cast<std::uint32_t>(_mm256_movemask_epi8(equalAvx2<sizeof(T)>(_mm256_loadu_si256(p + 1), needle)));
+        matchedBytes += static_cast<std::size_t>(std::popcount(m0 | (std::uint64_t(m1) << 32)));
+    }
+    for (; i + perRegister <= count; i += perRegister) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        matchedBytes += static_cast<std::size_t>(
+            std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(equalAvx2<sizeof(T)>(values, needle)))));
+    }
+    return matchedBytes / sizeof(T) + countEqualScalar(data + i, count - i, value);
+}
+
+#endif // STL_SIMD_X86
+
+} // namespace count_detail
+
+// Number of elements of data[0, count) equal to 'value'.
+// 'level' caps the instruction set used; the default is the best the CPU has.
+template <CountableInteger T>
+std::size_t countEqual(const T* data, std::size_t count, T value, SimdLevel level = bestSimdLevel()) {
+#if defined(STL_SIMD_X86)
+    switch (usableSimdLevel(level)) {
+        case SimdLevel::Avx2: return count_detail::countEqualAvx2(data, count, value);
+        case SimdLevel::Sse41: return count_detail::countEqualSse41(data, count, value);
+        case SimdLevel::Scalar: break;
+    }
+#endif
+    (void)level;
+    return count_detail::countEqualScalar(data, count, value);
+}
+
+template <std::ranges::contiguous_range Range>
+requires CountableInteger<std::ranges::range_value_t<Range>>
+std::size_t countEqual(const Range& range, std::ranges::range_value_t<Range> value, SimdLevel level = bestSimdLevel()) {
+    return countEqual(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), value, level);
+}
+
+// counts[v - low] = number of elements equal to v, for every v in [low, high].
+// Elements outside [low, high] are not counted.
+template <CountableInteger T>
+std::vector<std::size_t> histogram(const T* data, std::size_t count, T low, T high) {
+    if (high < low) {
+        throw std::invalid_argument("histogram: low is greater than high");
+    }
+    using U = std::make_unsigned_t<T>;
+    // Offsets are computed in the unsigned type, so values below 'low' wrap around to large offsets.
+    const U domainMinusOne = static_cast<U>(static_cast<U>(high) - static_cast<U>(low));
+    // The tables below hold 4 * (domain + 1) = 4 * (domainMinusOne + 2) counters; that must not overflow.
+    if (static_cast<std::uintmax_t>(domainMinusOne) >= static_cast<std::uintmax_t>(SIZE_MAX / 4 - 1)) {
+        throw std::length_error("histogram: value domain too large");
+    }
+    const std::size_t domain = static_cast<std::size_t>(domainMinusOne) + 1;
+
+    // Four tables side by side: element i goes to table i % 4. Each table has one extra
+    // slot at the end that collects the values outside [low, high] without a branch.
+    const std::size_t stride = domain + 1;
+    std::vector<std::size_t> tables(4 * stride, 0);
+    auto add = [&](std::size_t table, T value) {
+        U offset = static_cast<U>(static_cast<U>(value) - static_cast<U>(low));
+        std::size_t slot = offset <= domainMinusOne ? static_cast<std::size_t>(offset) : domain;
+        ++tables[table * stride + slot];
+    };
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        add(0, data[i]);
+        add(1, data[i + 1]);
+        add(2, data[i + 2]);
+        add(3, data[i + 3]);
+    }
+    for (; i < count; ++i) {
+        add(0, data[i]);
+    }
+
+    std::vector<std::size_t> counts(domain);
+    for (std::size_t v = 0; v < domain; ++v) {
+        counts[v] = tables[v] + tables[stride + v] + tables[2 * stride + v] + tables[3 * stride + v];
+    }
+    return counts;
+}
+
+template <std::ranges::contiguous_range Range>
+requires CountableInteger<std::ranges::range_value_t<Range>>
+std::vector<std::size_t> histogram(const Range& range, std::ranges::range_value_t<Range> low,
+                                   std::ranges::range_value_t<Range> high) {
+    return histogram(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), low, high);
+}
+
+// counts[k] = number of elements equal to values[k].
+template <CountableInteger T>
+std::vector<std::size_t> countEach(const T* data, std::size_t count, std::span<const T> values,
+                                   SimdLevel level = bestSimdLevel()) {
+    std::vector<std::size_t> counts(values.size());
+    if (values.empty()) {
+        return counts;
+    }
+    auto [low, high] = std::minmax_element(values.begin(), values.end());
+    using U = std::make_unsigned_t<T>;
+    auto domainMinusOne = static_cast<std::uintmax_t>(static_cast<U>(static_cast<U>(*high) - static_cast<U>(*low)));
+    if (values.size() >= countEachHistogramMinValues && domainMinusOne < countEachHistogramMaxDomain) {
+        std::vector<std::size_t> all = histogram(data, count, *low, *high);
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            counts[k] = all[static_cast<U>(static_cast<U>(values[k]) - static_cast<U>(*low))];
+        }
+    } else {
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            counts[k] = countEqual(data, count, values[k], level);
+        }
+    }
+    return counts;
+}
+
+template <std::ranges::contiguous_range Range>
+requires CountableInteger<std::ranges::range_value_t<Range>>
+std::vector<std::size_t> countEach(const Range& range, std::span<const std::ranges::range_value_t<Range>> values,
+                                   SimdLevel level = bestSimdLevel()) {
+    return countEach(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), values, level);
+}
+
+#endif // COUNT_VALUES_H
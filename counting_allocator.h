@@ -0,0 +1,75 @@
+#ifndef COUNTING_ALLOCATOR_H
+#define COUNTING_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+/*
+ * CountingAllocator: an allocator that forwards to std::allocator and records
+ * every allocation in an AllocationStats object, so we can see what a container
+ * really asks from the heap (number of allocations, bytes, peak live bytes).
+ *
+ * The stats object is shared by all rebound copies of the allocator, so the
+ * nodes, buckets and blocks a container allocates internally are all counted.
+ */
+
+struct AllocationStats {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytesAllocated = 0;
+    std::size_t liveBytes = 0;
+    std::size_t peakLiveBytes = 0;
+
+    void recordAllocation(std::size_t bytes) {
+        ++allocations;
+        bytesAllocated += bytes;
+        liveBytes += bytes;
+        peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+    }
+
+    void recordDeallocation(std::size_t bytes) {
+        ++deallocations;
+        liveBytes -= bytes;
+    }
+
+    void reset() {
+        *this = AllocationStats{};
+    }
+};
+
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationStats& stats) noexcept : stats_(&stats) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : stats_(other.stats()) {}
+
+    T* allocate(std::size_t n) {
+        T* memory = std::allocator<T>().allocate(n);
+        stats_->recordAllocation(n * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, std::size_t n) noexcept {
+        stats_->recordDeallocation(n * sizeof(T));
+        std::allocator<T>().deallocate(memory, n);
+    }
+
+    AllocationStats* stats() const noexcept {
+        return stats_;
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {
+        return stats_ == other.stats();
+    }
+
+private:
+    AllocationStats* stats_;
+};
+
+#endif // COUNTING_ALLOCATOR_H
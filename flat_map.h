@@ -0,0 +1,304 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+ * flat_set, flat_multiset, flat_map and flat_multimap: the same sorted containers as
+ * std::set / std::map, but stored in one sorted std::vector instead of a red-black tree.
+ *
+ * Lookups are binary searches over contiguous memory and iteration is a plain array walk,
+ * which is much kinder to the cache than chasing tree nodes. The price is O(n) inserts
+ * and erases in the middle. Inserting many elements at once with insert(first, last)
+ * appends them, sorts only the new part and merges it in (one sort + one merge).
+ *
+ * Like boost::container::flat_map, the elements of a flat_map are std::pair<Key, T>
+ * (not pair<const Key, T>); changing a key through an iterator breaks the ordering.
+ */
+
+namespace flat_detail {
+
+struct Identity {
+    template <typename T>
+    const T& operator()(const T& value) const {
+        return value;
+    }
+};
+
+struct FirstOf {
+    template <typename Pair>
+    const auto& operator()(const Pair& pair) const {
+        return pair.first;
+    }
+};
+
+} // namespace flat_detail
+
+// The sorted vector shared by all four containers.
+// KeyOf extracts the key from a stored value, Unique selects set/map vs multiset/multimap.
+template <typename Key, typename Value, typename KeyOf, typename Compare, bool Unique>
+class flat_tree {
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_compare = Compare;
+    using container_type = std::vector<Value>;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+    flat_tree() = default;
+
+    explicit flat_tree(const Compare& compare) : compare_(compare) {}
+
+    flat_tree(std::initializer_list<value_type> values, const Compare& compare = Compare()) : compare_(compare) {
+        insert(values.begin(), values.end());
+    }
+
+    template <std::input_iterator InputIt>
+    flat_tree(InputIt first, InputIt last, const Compare& compare = Compare()) : compare_(compare) {
+        insert(first, last);
+    }
+
+    // Iterators
+
+    iterator begin() noexcept { return data_.begin(); }
+    const_iterator begin() const noexcept { return data_.begin(); }
+    const_iterator cbegin() const noexcept { return data_.cbegin(); }
+    iterator end() noexcept { return data_.end(); }
+    const_iterator end() const noexcept { return data_.end(); }
+    const_iterator cend() const noexcept { return data_.cend(); }
+    reverse_iterator rbegin() noexcept { return data_.rbegin(); }
+    const_reverse_iterator rbegin() const noexcept { return data_.rbegin(); }
+    reverse_iterator rend() noexcept { return data_.rend(); }
+    const_reverse_iterator rend() const noexcept { return data_.rend(); }
+
+    // The sorted elements, contiguous in memory.
+    const value_type* data() const noexcept { return data_.data(); }
+
+    // Capacity
+
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+    size_type capacity() const noexcept { return data_.capacity(); }
+    void reserve(size_type count) { data_.reserve(count); }
+    void shrink_to_fit() { data_.shrink_to_fit(); }
+
+    // Modifiers
+
+    void clear() noexcept { data_.clear(); }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return insertValue(value_type(value));
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return insertValue(std::move(value));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insertValue(value_type(std::forward<Args>(args)...));
+    }
+
+    // Bulk insert: append, sort the new elements, merge them with the old ones.
+    // For the unique containers, keys that are already present (or repeated in the
+    // batch) keep the element that was there first, just like std::map::insert.
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last) {
+        auto oldSize = static_cast<difference_type>(data_.size());
+        data_.insert(data_.end(), first, last);
+        auto middle = data_.begin() + oldSize;
+        auto valueLess = [this](const value_type& a, const value_type& b) { return lessKey(KeyOf{}(a), KeyOf{}(b)); };
+        std::stable_sort(middle, data_.end(), valueLess);
+        std::inplace_merge(data_.begin(), middle, data_.end(), valueLess);
+        if constexpr (Unique) {
+            auto sameKey = [this](const value_type& a, const value_type& b) {
+                return !lessKey(KeyOf{}(a), KeyOf{}(b)) && !lessKey(KeyOf{}(b), KeyOf{}(a));
+            };
+            data_.erase(std::unique(data_.begin(), data_.end(), sameKey), data_.end());
+        }
+    }
+
+    void insert(std::initializer_list<value_type> values) {
+        insert(values.begin(), values.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return data_.erase(position);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return data_.erase(first, last);
+    }
+
+    size_type erase(const key_type& key) {
+        auto [first, last] = equal_range(key);
+        auto count = static_cast<size_type>(last - first);
+        data_.erase(first, last);
+        return count;
+    }
+
+    void swap(flat_tree& other) noexcept {
+        using std::swap;
+        swap(data_, other.data_);
+        swap(compare_, other.compare_);
+    }
+
+    // Lookup
+
+    iterator find(const key_type& key) {
+        auto it = lower_bound(key);
+        return it != end() && !lessKey(key, KeyOf{}(*it)) ? it : end();
+    }
+
+    const_iterator find(const key_type& key) const {
+        auto it = lower_bound(key);
+        return it != end() && !lessKey(key, KeyOf{}(*it)) ? it : end();
+    }
+
+    bool contains(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    size_type count(const key_type& key) const {
+        auto [first, last] = equal_range(key);
+        return static_cast<size_type>(last - first);
+    }
+
+    iterator lower_bound(const key_type& key) {
+        return std::partition_point(begin(), end(), [&](const value_type& value) { return lessKey(KeyOf{}(value), key); });
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        return std::partition_point(begin(), end(), [&](const value_type& value) { return lessKey(KeyOf{}(value), key); });
+    }
+
+    iterator upper_bound(const key_type& key) {
+        return std::partition_point(begin(), end(), [&](const value_type& value) { return !lessKey(key, KeyOf{}(value)); });
+    }
+
+    const_iterator upper_bound(const key_type& key) const {
+        return std::partition_point(begin(), end(), [&](const value_type& value) { return !lessKey(key, KeyOf{}(value)); });
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    key_compare key_comp() const {
+        return compare_;
+    }
+
+    friend bool operator==(const flat_tree& a, const flat_tree& b) {
+        return a.data_ == b.data_;
+    }
+
+protected:
+    bool lessKey(const key_type& a, const key_type& b) const {
+        return compare_(a, b);
+    }
+
+    std::pair<iterator, bool> insertValue(value_type&& value) {
+        const key_type& key = KeyOf{}(value);
+        if constexpr (Unique) {
+            auto it = lower_bound(key);
+            if (it != end() && !lessKey(key, KeyOf{}(*it))) {
+                return {it, false};
+            }
+            return {data_.insert(it, std::move(value)), true};
+        } else {
+            // Equal keys keep their insertion order, like std::multimap.
+            auto it = upper_bound(key);
+            return {data_.insert(it, std::move(value)), true};
+        }
+    }
+
+    container_type data_;
+    [[no_unique_address]] Compare compare_;
+};
+
+template <typename T, typename Compare = std::less<T>>
+using flat_set = flat_tree<T, T, flat_detail::Identity, Compare, true>;
+
+template <typename T, typename Compare = std::less<T>>
+using flat_multiset = flat_tree<T, T, flat_detail::Identity, Compare, false>;
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_multimap : public flat_tree<Key, std::pair<Key, T>, flat_detail::FirstOf, Compare, false> {
+    using Base = flat_tree<Key, std::pair<Key, T>, flat_detail::FirstOf, Compare, false>;
+
+public:
+    using mapped_type = T;
+    using Base::Base;
+};
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map : public flat_tree<Key, std::pair<Key, T>, flat_detail::FirstOf, Compare, true> {
+    using Base = flat_tree<Key, std::pair<Key, T>, flat_detail::FirstOf, Compare, true>;
+
+public:
+    using mapped_type = T;
+    using typename Base::iterator;
+    using Base::Base;
+
+    T& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    T& at(const Key& key) {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("flat_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("flat_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    // Only builds the mapped value when the key is not there yet.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        auto it = this->lower_bound(key);
+        if (it != this->end() && !this->lessKey(key, it->first)) {
+            return {it, false};
+        }
+        it = this->data_.emplace(it, std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+        return {it, true};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+};
+
+#endif // FLAT_MAP_H
@@ -13,6 +13,17 @@
 #include <unordered_set>
 #include <unordered_map>
 
+#include "allocation_report.h"
+#include "count_values.h"
+#include "flat_map.h"
+#include "min_max.h"
+#include "output_sink.h"
+#include "parallel_sum.h"
+#include "pmr_report.h"
+#include "printers.h"
+#include "radix_sort.h"
+#include "swiss_table.h"
+
 /*
  *
  * Author: Aman Arabzadeh
@@ -34,233 +45,210 @@
  *      (input iterators, output iterators, forward iterators, bidirectional iterators, random access iterators)
  */
 
+// The generic print* templates live in printers.h, the buffered OutputSink in output_sink.h.
 
+int main(int argc, char* argv[]) {
+    // All demo output goes through one buffered sink instead of flushing std::cout line by line.
+    OutputSink out;
+    // Exit status 1 when the output did not all arrive (stdout closed, disk full, ...).
+    auto exitStatus = [&out] {
+        out.flush();
+        return out.failed() ? 1 : 0;
+    };
 
-// Generic Programming or meta programming example, Very important for us
-// We let the compiler generate the appropriate container to print from.
-
-
-template <typename  T>
-void printContainerForLoop(const T& container) {
-    std::cout << "Printing: ";
-    for (const auto& el : container) {
-        std::cout << el << " ";
-    }
-    std::cout << std::endl;
-}
-
-template <typename Key, typename Value>
-void printMap(const std::map<Key, Value>& container) {
-    std::cout << "Printing: ";
-    for (const auto& el : container) {
-        std::cout << "{" << el.first << ": " << el.second << "} ";
-    }
-    std::cout << std::endl;
-}
-
-template <typename Key, typename Value>
-void printMapIterator(const std::map<Key, Value>& container) {
-    std::cout << "Map elements: ";
-    for (auto it = container.begin(); it != container.end(); ++it) {
-        std::cout << "{" << it->first << ": " << it->second << "} ";
-    }
-    std::cout << std::endl;
-}
-
-template <typename T>
-void printContainerIterator(const T& container) {
-    std::cout << "Printing: ";
-    for (auto it = container.begin(); it != container.end(); ++it) {
-        std::cout << *it << " ";
-    }
-    std::cout << std::endl;
-}
-
-template<typename KeyType, typename ValueType>
-void printUnorderedMultimap(const std::unordered_multimap<KeyType, ValueType>& myUnorderedMultimap) {
-    std::cout << "Unordered_multimap elements: ";
-
-    for (const auto& pair : myUnorderedMultimap) {
-        std::cout << "{" << pair.first << ", " << pair.second << "} ";
+    // Report modes, each runs every container section below with 'count' elements:
+    //   --alloc-report [count]  how much heap memory each container really uses
+    //   --pmr-report [count]    default heap vs std::pmr monotonic and pool resources
+    std::string mode = argc > 1 ? argv[1] : "";
+    std::size_t count = argc > 2 ? std::stoull(argv[2]) : 1'000'000;
+    if (mode == "--alloc-report") {
+        runAllocationReport(out, count);
+        return exitStatus();
     }
-
-    std::cout << std::endl;
-}
-
-template<typename KeyType, typename ValueType>
-void printUnorderedMap(const std::unordered_map<KeyType, ValueType>& myUnorderedMap) {
-    std::cout << "Unordered_map elements: ";
-
-    for (const auto& pair : myUnorderedMap) {
-        std::cout << "{" << pair.first << ", " << pair.second << "} ";
+    if (mode == "--pmr-report") {
+        runArenaReport(out, count);
+        return exitStatus();
     }
 
-    std::cout << std::endl;
-}
-template<typename KeyType, typename ValueType>
-void printMultimap(const std::multimap<KeyType, ValueType>& myMultimap) {
-    std::cout << "Multimap elements: ";
-
-    for (const auto& pair : myMultimap) {
-        std::cout << "{" << pair.first << ", " << pair.second << "} ";
-    }
-
-    std::cout << std::endl;
-}
-
-int main() {
-    auto newLine = []() {
-        std::cout << "\n\n";
+    auto newLine = [&out]() {
+        out << "\n\n";
     };
 
     // Containers
 
     // Vector implementation
     std::vector<int> numbers = {5, 2, 8, 4, 1};
-    std::cout << "Vector elements: ";
-    printContainerIterator(numbers);
-    std::cout << "Use vector when you need a dynamic array that allows efficient insertion and deletion at the end, and random access to elements." << std::endl;
+    out << "Vector elements: ";
+    printContainerIterator(numbers, out);
+    out << "Use vector when you need a dynamic array that allows efficient insertion and deletion at the end, and random access to elements." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/vector
     newLine();
 
     // List implementation
     std::list<int> myList = {3, 7, 2, 9, 5};
-    std::cout << "List elements: ";
-    printContainerIterator(myList);
-    std::cout << "Use list when you need a doubly linked list that allows efficient insertion and deletion at any position, but random access is not required." << std::endl;
+    // std::sort needs random access iterators; containerSort (container_algorithms.h) also sorts lists, fast.
+    // pooled_list (pool_allocator.h) takes its nodes from slabs instead of one heap allocation per element.
+    out << "List elements: ";
+    printContainerIterator(myList, out);
+    out << "Use list when you need a doubly linked list that allows efficient insertion and deletion at any position, but random access is not required." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/list
     newLine();
 
     // Deque implementation
+    // ring_deque (ring_deque.h) keeps the elements in one ring buffer instead of 512-byte blocks: faster to iterate and index.
     std::deque<int> myDeque = {4, 6, 2, 7, 9};
-    std::cout << "Deque elements: ";
-    printContainerIterator(myDeque);
-    std::cout << "Use deque when you need a double-ended queue that allows efficient insertion and deletion at both ends, but random access is slower compared to vector." << std::endl;
+    out << "Deque elements: ";
+    printContainerIterator(myDeque, out);
+    out << "Use deque when you need a double-ended queue that allows efficient insertion and deletion at both ends, but random access is slower compared to vector." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/deque
     newLine();
 
     // Set implementation
     std::set<int> mySet = {1, 2, 3, 2, 4, 5};
-    std::cout << "Set elements: ";
-    printContainerIterator(mySet);
-    std::cout << "Use set when you need a container that stores unique elements in sorted order, and efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Set elements: ";
+    printContainerIterator(mySet, out);
+    out << "Use set when you need a container that stores unique elements in sorted order, and efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/set
     newLine();
 
     // Multiset implementation
     std::multiset<int> myMultiset = {1, 2, 3, 2, 4, 5};
-    std::cout << "Multiset elements: ";
-    printContainerIterator(myMultiset);
-    std::cout << "Use multiset when you need a container that stores multiple occurrences of elements in sorted order, and efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Multiset elements: ";
+    printContainerIterator(myMultiset, out);
+    out << "Use multiset when you need a container that stores multiple occurrences of elements in sorted order, and efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/multiset
     newLine();
 
     // Map implementation
     std::map<std::string, int> myMap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}};
-    std::cout << "Map elements: ";
-    printMapIterator(myMap);
-    std::cout << "Use map when you need a container that stores key-value pairs in sorted order of keys, and efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Map elements: ";
+    printMapIterator(myMap, out);
+    out << "Use map when you need a container that stores key-value pairs in sorted order of keys, and efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/map
     newLine();
 
     // Multimap implementation
     std::multimap<std::string, int> myMultimap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}, {"Alice", 40}};
-    std::cout << "Multimap elements: ";
-    printMultimap(myMultimap);
-    std::cout << "Use multimap when you need a container that stores multiple key-value pairs in sorted order of keys, and efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Multimap elements: ";
+    printMultimap(myMultimap, out);
+    out << "Use multimap when you need a container that stores multiple key-value pairs in sorted order of keys, and efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/multimap
     newLine();
 
+    // Flat_set and flat_map implementation (flat_map.h, not part of the STL until C++23)
+    flat_set<int> myFlatSet = {1, 2, 3, 2, 4, 5};
+    out << "Flat_set elements: ";
+    printContainerIterator(myFlatSet, out);
+    flat_map<std::string, int> myFlatMap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}};
+    out << "Flat_map elements: ";
+    printContainer(myFlatMap, out);
+    out << "Use flat_set / flat_map when lookups and iteration dominate: they keep the same sorted order as set / map in one contiguous array, which is much faster to search and walk, but inserting or erasing in the middle costs O(n)." << '\n';
+    // Further reading: https://en.cppreference.com/w/cpp/container/flat_map
+    newLine();
+
     // Stack implementation
+    // std::stack sits on a std::deque and allocates even for five ints; small_stack<int, 8> (small_vector.h) does not.
     std::stack<int> myStack;
     for (int i = 0; i < 5; ++i) {
         myStack.push(i);
     }
-    std::cout << "Stack elements: ";
+    out << "Stack elements: ";
     while (!myStack.empty()) {
-        std::cout << myStack.top() << " ";
+        out << myStack.top() << " ";
         myStack.pop();
     }
-    std::cout << std::endl;
-    std::cout << "Use stack when you need a Last-In-First-Out (LIFO) data structure that allows insertion and deletion at the top." << std::endl;
+    out << '\n';
+    out << "Use stack when you need a Last-In-First-Out (LIFO) data structure that allows insertion and deletion at the top." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/stack
     newLine();
 
     // Queue implementation
+    // std::queue is not thread-safe: to pass elements from one thread to another, use SpscQueue (spsc_queue.h),
+    // or MpmcQueue (mpmc_queue.h) for many producers and consumers.
     std::queue<int> myQueue;
     for (int i = 0; i < 5; ++i) {
         myQueue.push(i);
     }
-    std::cout << "Queue elements: ";
+    out << "Queue elements: ";
     while (!myQueue.empty()) {
-        std::cout << myQueue.front() << " ";
+        out << myQueue.front() << " ";
         myQueue.pop();
     }
-    std::cout << std::endl;
-    std::cout << "Use queue when you need a First-In-First-Out (FIFO) data structure that allows insertion at the back and deletion at the front." << std::endl;
+    out << '\n';
+    out << "Use queue when you need a First-In-First-Out (FIFO) data structure that allows insertion at the back and deletion at the front." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/queue
     newLine();
 
     // Priority Queue implementation
+    // No decrease-key here: see DaryHeap, IndexedHeap (update / erase by id) and RadixHeap in priority_heaps.h.
     std::priority_queue<int> myPriorityQueue;
     for (int i = 0; i < 5; ++i) {
         myPriorityQueue.push(i);
     }
-    std::cout << "Priority Queue elements: ";
+    out << "Priority Queue elements: ";
     while (!myPriorityQueue.empty()) {
-        std::cout << myPriorityQueue.top() << " ";
+        out << myPriorityQueue.top() << " ";
         myPriorityQueue.pop();
     }
-    std::cout << std::endl;
-    std::cout << "Use priority_queue when you need a container that provides retrieval of elements based on priority, with the highest priority element always at the front." << std::endl;
+    out << '\n';
+    out << "Use priority_queue when you need a container that provides retrieval of elements based on priority, with the highest priority element always at the front." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/priority_queue
     newLine();
 
     // Forward_list implementation
     std::forward_list<int> myForwardList = {1, 2, 3, 4, 5};
-    std::cout << "Forward_list elements: ";
-    printContainerIterator(myForwardList);
-    std::cout << "Use forward_list when you need a singly linked list that allows efficient insertion and deletion at any position, but no backward traversal is possible." << std::endl;
+    // pooled_forward_list (pool_allocator.h) carves the nodes out of slabs, so they sit close together in memory.
+    out << "Forward_list elements: ";
+    printContainerIterator(myForwardList, out);
+    out << "Use forward_list when you need a singly linked list that allows efficient insertion and deletion at any position, but no backward traversal is possible." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/forward_list
     newLine();
 
     // Array implementation
     std::array<int, 5> myArray = {1, 2, 3, 4, 5};
-    std::cout << "Array elements: ";
-    printContainerIterator(myArray);
-    std::cout << "Use array when you need a fixed-size container with a known size at compile time." << std::endl;
+    out << "Array elements: ";
+    printContainerIterator(myArray, out);
+    out << "Use array when you need a fixed-size container with a known size at compile time." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/array
     newLine();
 
     // Unordered_set implementation
     std::unordered_set<int> myUnorderedSet = {1, 2, 3, 2, 4, 5};
-    std::cout << "Unordered_set elements: ";
-    printContainerIterator(myUnorderedSet);
-    std::cout << "Use unordered_set when you need a container that stores unique elements in any order, and provides efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Unordered_set elements: ";
+    printContainerIterator(myUnorderedSet, out);
+    out << "Use unordered_set when you need a container that stores unique elements in any order, and provides efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/unordered_set
     newLine();
 
     // Unordered_map implementation
+    // unordered_map is not thread-safe; ConcurrentHashMap (concurrent_map.h) locks shards instead of the whole map.
     std::unordered_map<std::string, int> myUnorderedMap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}};
-    std::cout << "Unordered_map elements: ";
-    printUnorderedMap(myUnorderedMap);
-    std::cout << "Use unordered_map when you need a container that stores key-value pairs in any order, and provides efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Unordered_map elements: ";
+    printUnorderedMap(myUnorderedMap, out);
+    out << "Use unordered_map when you need a container that stores key-value pairs in any order, and provides efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/unordered_map
     newLine();
 
+    // Swiss_map implementation (swiss_table.h, an open-addressing alternative to unordered_map)
+    swiss_map<std::string, int> mySwissMap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}};
+    out << "Swiss_map elements: ";
+    printContainer(mySwissMap, out, "Printing: ", ", ");
+    out << "Use swiss_map when you need an unordered_map that is fast to search: all elements live in one flat array and lookups compare a group of hash tags at once instead of following bucket pointers, but inserts may move elements around." << '\n';
+    newLine();
+
     // Unordered_multimap implementation
     std::unordered_multimap<std::string, int> myUnorderedMultimap = {{"Alice", 25}, {"Bob", 30}, {"Charlie", 35}, {"Alice", 40}};
-    std::cout << "Unordered_multimap elements: ";
-    printUnorderedMultimap(myUnorderedMultimap);
-    std::cout << "Use unordered_multimap when you need a container that stores multiple key-value pairs in any order, and provides efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Unordered_multimap elements: ";
+    printUnorderedMultimap(myUnorderedMultimap, out);
+    out << "Use unordered_multimap when you need a container that stores multiple key-value pairs in any order, and provides efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/unordered_multimap
     newLine();
 
     // Unordered_multiset implementation
     std::unordered_multiset<int> myUnorderedMultiset = {1, 2, 3, 2, 4, 5};
-    std::cout << "Unordered_multiset elements: ";
-    printContainerIterator(myUnorderedMultiset);
-    std::cout << "Use unordered_multiset when you need a container that stores multiple occurrences of elements in any order, and provides efficient insertion, deletion, and searching based on keys." << std::endl;
+    out << "Unordered_multiset elements: ";
+    printContainerIterator(myUnorderedMultiset, out);
+    out << "Use unordered_multiset when you need a container that stores multiple occurrences of elements in any order, and provides efficient insertion, deletion, and searching based on keys." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/container/unordered_multiset
     newLine();
 
@@ -268,54 +256,64 @@ int main() {
     // Algorithms
 
     // Sort the vector in ascending order
-    std::sort(numbers.begin(), numbers.end());
-    std::cout << "Sorted vector: ";
-    printContainerIterator(numbers);
-    std::cout << "Use sort algorithm to sort the elements of a container in a specified order." << std::endl;
+    // fastSort is std::sort, except that large integer / floating point ranges get a radix sort.
+    fastSort(numbers.begin(), numbers.end());
+    out << "Sorted vector: ";
+    printContainerIterator(numbers, out);
+    out << "Use sort algorithm to sort the elements of a container in a specified order." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/sort
+    // For many binary searches over the same sorted vector, build an EytzingerIndex / BTreeIndex (search_index.h) once.
     newLine();
 
     // Find the minimum and maximum element in the vector
-    int minElement = *std::min_element(numbers.begin(), numbers.end());
-    int maxElement = *std::max_element(numbers.begin(), numbers.end());
-    std::cout << "Minimum element: " << minElement << std::endl;
-    std::cout << "Maximum element: " << maxElement << std::endl;
-    std::cout << "Use min_element and max_element algorithms to find the minimum and maximum elements in a container, respectively." << std::endl;
+    // minMax finds both (and their positions) in one pass, where min_element + max_element take two.
+    // statistics (statistics.h) adds sum, mean, variance and a value count to the same single pass.
+    MinMaxResult<int> extremes = minMax(numbers);
+    int minElement = extremes.min;
+    int maxElement = extremes.max;
+    out << "Minimum element: " << minElement << '\n';
+    out << "Maximum element: " << maxElement << '\n';
+    out << "Use min_element and max_element algorithms to find the minimum and maximum elements in a container, respectively." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/min_element, https://en.cppreference.com/w/cpp/algorithm/max_element
     newLine();
 
     // Use iterators to find and erase an element
+    // One erase shifts the whole tail: to remove many elements use eraseValues / unstableEraseIf (batch_erase.h).
     auto iter = std::find(numbers.begin(), numbers.end(), 4);
     if (iter != numbers.end()) {
         numbers.erase(iter);
-        std::cout << "Element 4 erased." << std::endl;
+        out << "Element 4 erased." << '\n';
     }
-    std::cout << "Use find algorithm to search for a specific element in a container, and erase algorithm to remove an element from a container." << std::endl;
+    out << "Use find algorithm to search for a specific element in a container, and erase algorithm to remove an element from a container." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/find, https://en.cppreference.com/w/cpp/algorithm/erase
     newLine();
 
     // Use the count algorithm to count occurrences of a value
-    int countTwos = std::count(numbers.begin(), numbers.end(), 2);
-    std::cout << "Count of 2s: " << countTwos << std::endl;
-    std::cout << "Use count algorithm to count the occurrences of a value in a container." << std::endl;
+    // countEqual is std::count with SIMD compares; countEach / histogram count many values in one pass.
+    int countTwos = static_cast<int>(countEqual(numbers, 2));
+    out << "Count of 2s: " << countTwos << '\n';
+    out << "Use count algorithm to count the occurrences of a value in a container." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/count
     newLine();
 
     // Use the transform algorithm to square each element
+    // This writes every square back before the sum below reads it again; when only the sum is needed,
+    // pipeline(numbers).map([](int num) { return num * num; }).sum() (pipeline.h) does it in one pass, writing nothing.
     std::transform(numbers.begin(), numbers.end(), numbers.begin(),
                    [](int num) { return num * num; });
-    std::cout << "Transformed vector: ";
-    printContainerIterator(numbers);
-    std::cout << "Use transform algorithm to apply a specified operation on each element of a container and store the result." << std::endl;
+    out << "Transformed vector: ";
+    printContainerIterator(numbers, out);
+    out << "Use transform algorithm to apply a specified operation on each element of a container and store the result." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/transform
     newLine();
 
     // Use the accumulate algorithm to sum the vector elements
-    int sum = std::accumulate(numbers.begin(), numbers.end(), 0);
-    std::cout << "Sum of elements: " << sum << std::endl;
-    std::cout << "Use accumulate algorithm to compute the sum of elements in a container." << std::endl;
+    // parallelSum adds in long long (no int overflow) and uses every core on large vectors.
+    long long sum = parallelSum(numbers);
+    out << "Sum of elements: " << sum << '\n';
+    out << "Use accumulate algorithm to compute the sum of elements in a container." << '\n';
     // Further reading: https://en.cppreference.com/w/cpp/algorithm/accumulate
     newLine();
 
-    return 0;
+    return exitStatus();
 }
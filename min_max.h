@@ -0,0 +1,326 @@
+#ifndef MIN_MAX_H
+#define MIN_MAX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+
+#include "simd_dispatch.h"
+
+/*
+ * minMax: the minimum and maximum of a contiguous range, and their positions, in one pass.
+ *
+ * std::min_element followed by std::max_element reads the data twice; minMax reads it once.
+ * For int, float and double the loop runs on SSE4.1 or AVX2 registers (picked at run time,
+ * see simd_dispatch.h): every lane keeps its own running min / max and the index where it
+ * was seen, and the lanes are combined at the end. Other element types use a scalar loop.
+ *
+ * Positions are the first occurrence, exactly like min_element / max_element. An empty
+ * range returns value-initialized values and both indices equal to 0 (the "end").
+ * With NaNs in a float range the result is unspecified, as it is for std::min_element.
+ */
+
+template <typename T>
+struct MinMaxResult {
+    T min{};
+    T max{};
+    std::size_t minIndex = 0;
+    std::size_t maxIndex = 0;
+};
+
+namespace minmax_detail {
+
+// The element types that have SIMD kernels.
+template <typename T>
+constexpr bool hasKernels = std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename T>
+MinMaxResult<T> minMaxScalar(const T* data, std::size_t count) {
+    MinMaxResult<T> result;
+    if (count == 0) {
+        return result;
+    }
+    result.min = data[0];
+    result.max = data[0];
+    for (std::size_t i = 1; i < count; ++i) {
+        if (data[i] < result.min) {
+            result.min = data[i];
+            result.minIndex = i;
+        }
+        if (result.max < data[i]) {
+            result.max = data[i];
+            result.maxIndex = i;
+        }
+    }
+    return result;
+}
+
+// Combines the per-lane results of a kernel, then finishes the elements in [tail, count).
+template <typename T, typename Index, std::size_t Lanes>
+MinMaxResult<T> reduceLanes(const T* data, std::size_t count, std::size_t tail,
+                            const T (&mins)[Lanes], const Index (&minAt)[Lanes],
+                            const T (&maxs)[Lanes], const Index (&maxAt)[Lanes]) {
+    MinMaxResult<T> result{mins[0], maxs[0], minAt[0], maxAt[0]};
+    for (std::size_t lane = 1; lane < Lanes; ++lane) {
+        // Equal values: the lane that saw it first wins.
+        if (mins[lane] < result.min || (!(result.min < mins[lane]) && minAt[lane] < result.minIndex)) {
+            result.min = mins[lane];
+            result.minIndex = minAt[lane];
+        }
+        if (result.max < maxs[lane] || (!(maxs[lane] < result.max) && maxAt[lane] < result.maxIndex)) {
+            result.max = maxs[lane];
+            result.maxIndex = maxAt[lane];
+        }
+    }
+    for (std::size_t i = tail; i < count; ++i) {
+        if (data[i] < result.min) {
+            result.min = data[i];
+            result.minIndex = i;
+        }
+        if (result.max < data[i]) {
+            result.max = data[i];
+            result.maxIndex = i;
+        }
+    }
+    return result;
+}
+
+#if defined(STL_SIMD_X86)
+
+// Per-type register operations. less() returns an all-ones lane mask where a < b,
+// index vectors are 32-bit lanes for 4-byte elements and 64-bit lanes for double.
+
+template <typename T>
+struct Sse41Lanes;
+
+template <>
+struct Sse41Lanes<int> {
+    using Vec = __m128i;
+    using Index = std::uint32_t;
+    static constexpr std::size_t lanes = 4;
+    STL_TARGET_SSE41 static Vec load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    STL_TARGET_SSE41 static void store(int* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    STL_TARGET_SSE41 static __m128i less(Vec a, Vec b) { return _mm_cmpgt_epi32(b, a); }
+    STL_TARGET_SSE41 static Vec blend(Vec a, Vec b, __m128i mask) { return _mm_blendv_epi8(a, b, mask); }
+    STL_TARGET_SSE41 static __m128i firstIndices() { return _mm_setr_epi32(0, 1, 2, 3); }
+    STL_TARGET_SSE41 static __m128i addIndex(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    STL_TARGET_SSE41 static __m128i indexStep() { return _mm_set1_epi32(lanes); }
+};
+
+template <>
+struct Sse41Lanes<float> {
+    using Vec = __m128;
+    using Index = std::uint32_t;
+    static constexpr std::size_t lanes = 4;
+    STL_TARGET_SSE41 static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    STL_TARGET_SSE41 static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    STL_TARGET_SSE41 static __m128i less(Vec a, Vec b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+    STL_TARGET_SSE41 static Vec blend(Vec a, Vec b, __m128i mask) { return _mm_blendv_ps(a, b, _mm_castsi128_ps(mask)); }
+    STL_TARGET_SSE41 static __m128i firstIndices() { return _mm_setr_epi32(0, 1, 2, 3); }
+    STL_TARGET_SSE41 static __m128i addIndex(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    STL_TARGET_SSE41 static __m128i indexStep() { return _mm_set1_epi32(lanes); }
+};
+
+template <>
+struct Sse41Lanes<double> {
+    using Vec = __m128d;
+    using Index = std::uint64_t;
+    static constexpr std::size_t lanes = 2;
+    STL_TARGET_SSE41 static Vec load(const double* p) { return _mm_loadu_pd(p); }
+    STL_TARGET_SSE41 static void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+    STL_TARGET_SSE41 static __m128i less(Vec a, Vec b) { return _mm_castpd_si128(_mm_cmplt_pd(a, b)); }
+    STL_TARGET_SSE41 static Vec blend(Vec a, Vec b, __m128i mask) { return _mm_blendv_pd(a, b, _mm_castsi128_pd(mask)); }
+    STL_TARGET_SSE41 static __m128i firstIndices() { return _mm_set_epi64x(1, 0); }
+    STL_TARGET_SSE41 static __m128i addIndex(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+    STL_TARGET_SSE41 static __m128i indexStep() { return _mm_set1_epi64x(lanes); }
+};
+
+template <typename T>
+struct Avx2Lanes;
+
+template <>
+struct Avx2Lanes<int> {
+    using Vec = __m256i;
+    using Index = std::uint32_t;
+    static constexpr std::size_t lanes = 8;
+    STL_TARGET_AVX2 static Vec load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    STL_TARGET_AVX2 static void store(int* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    STL_TARGET_AVX2 static __m256i less(Vec a, Vec b) { return _mm256_cmpgt_epi32(b, a); }
+    STL_TARGET_AVX2 static Vec blend(Vec a, Vec b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+    STL_TARGET_AVX2 static __m256i firstIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    STL_TARGET_AVX2 static __m256i addIndex(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+    STL_TARGET_AVX2 static __m256i indexStep() { return _mm256_set1_epi32(lanes); }
+};
+
+template <>
+struct Avx2Lanes<float> {
+    using Vec = __m256;
+    using Index = std::uint32_t;
+    static constexpr std::size_t lanes = 8;
+    STL_TARGET_AVX2 static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    STL_TARGET_AVX2 static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    STL_TARGET_AVX2 static __m256i less(Vec a, Vec b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    STL_TARGET_AVX2 static Vec blend(Vec a, Vec b, __m256i mask) { return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(mask)); }
+    STL_TARGET_AVX2 static __m256i firstIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    STL_TARGET_AVX2 static __m256i addIndex(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+    STL_TARGET_AVX2 static __m256i indexStep() { return _mm256_set1_epi32(lanes); }
+};
+
+template <>
+struct Avx2Lanes<double> {
+    using Vec = __m256d;
+    using Index = std::uint64_t;
+    static constexpr std::size_t lanes = 4;
+    STL_TARGET_AVX2 static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    STL_TARGET_AVX2 static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    STL_TARGET_AVX2 static __m256i less(Vec a, Vec b) { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    STL_TARGET_AVX2 static Vec blend(Vec a, Vec b, __m256i mask) { return _mm256_blendv_pd(a, b, _mm256_castsi256_pd(mask)); }
+    STL_TARGET_AVX2 static __m256i firstIndices() { return _mm256_setr_epi64x(0, 1, 2, 3); }
+    STL_TARGET_AVX2 static __m256i addIndex(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+    STL_TARGET_AVX2 static __m256i indexStep() { return _mm256_set1_epi64x(lanes); }
+};
+
+// The two kernels are the same loop; a target attribute cannot depend on a template
+// parameter, so each instruction set gets its own copy. 'count' must be at least two
+// registers wide and small enough for the index lanes (see minMax()).
+
+template <typename T>
+STL_TARGET_SSE41 MinMaxResult<T> minMaxSse41(const T* data, std::size_t count) {
+    using L = Sse41Lanes<T>;
+    constexpr std::size_t lanes = L::lanes;
+    // Two independent accumulators per iteration, so the compare + blend chains overlap.
+    typename L::Vec minA = L::load(data);
+    typename L::Vec minB = L::load(data + lanes);
+    typename L::Vec maxA = minA;
+    typename L::Vec maxB = minB;
+    const __m128i step = L::indexStep();
+    __m128i indexA = L::firstIndices();
+    __m128i indexB = L::addIndex(indexA, step);
+    __m128i minAtA = indexA, maxAtA = indexA;
+    __m128i minAtB = indexB, maxAtB = indexB;
+    const __m128i step2 = L::addIndex(step, step);
+    std::size_t i = 2 * lanes;
+    for (; i + 2 * lanes <= count; i += 2 * lanes) {
+        indexA = L::addIndex(indexA, step2);
+        indexB = L::addIndex(indexB, step2);
+        typename L::Vec valuesA = L::load(data + i);
+        typename L::Vec valuesB = L::load(data + i + lanes);
+        __m128i lowerA = L::less(valuesA, minA);
+        __m128i lowerB = L::less(valuesB, minB);
+        __m128i higherA = L::less(maxA, valuesA);
+        __m128i higherB = L::less(maxB, valuesB);
+        minA = L::blend(minA, valuesA, lowerA);
+        minB = L::blend(minB, valuesB, lowerB);
+        maxA = L::blend(maxA, valuesA, higherA);
+        maxB = L::blend(maxB, valuesB, higherB);
+        minAtA = _mm_blendv_epi8(minAtA, indexA, lowerA);
+        minAtB = _mm_blendv_epi8(minAtB, indexB, lowerB);
+        maxAtA = _mm_blendv_epi8(maxAtA, indexA, higherA);
+        maxAtB = _mm_blendv_epi8(maxAtB, indexB, higherB);
+    }
+    T mins[2 * lanes], maxs[2 * lanes];
+    typename L::Index minAt[2 * lanes], maxAt[2 * lanes];
+    L::store(mins, minA);
+    L::store(mins + lanes, minB);
+    L::store(maxs, maxA);
+    L::store(maxs + lanes, maxB);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(minAt), minAtA);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(minAt + lanes), minAtB);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxAt), maxAtA);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxAt + lanes), maxAtB);
+    return reduceLanes(data, count, i, mins, minAt, maxs, maxAt);
+}
+
+template <typename T>
+STL_TARGET_AVX2 MinMaxResult<T> minMaxAvx2(const T* data, std::size_t count) {
+    using L = Avx2Lanes<T>;
+    constexpr std::size_t lanes = L::lanes;
+    // Two independent accumulators per iteration, so the compare + blend chains overlap.
+    typename L::Vec minA = L::load(data);
+    typename L::Vec minB = L::load(data + lanes);
+    typename L::Vec maxA = minA;
+    typename L::Vec maxB = minB;
+    const __m256i step = L::indexStep();
+    __m256i indexA = L::firstIndices();
+    __m256i indexB = L::addIndex(indexA, step);
+    __m256i minAtA = indexA, maxAtA = indexA;
+    __m256i minAtB = indexB, maxAtB = indexB;
+    const __m256i step2 = L::addIndex(step, step);
+    std::size_t i = 2 * lanes;
+    for (; i + 2 * lanes <= count; i += 2 * lanes) {
+        indexA = L::addIndex(indexA, step2);
+        indexB = L::addIndex(indexB, step2);
+        typename L::Vec valuesA = L::load(data + i);
+        typename L::Vec valuesB = L::load(data + i + lanes);
+        __m256i lowerA = L::less(valuesA, minA);
+        __m256i lowerB = L::less(valuesB, minB);
+        __m256i higherA = L::less(maxA, valuesA);
+        __m256i higherB = L::less(maxB, valuesB);
+        minA = L::blend(minA, valuesA, lowerA);
+        minB = L::blend(minB, valuesB, lowerB);
+        maxA = L::blend(maxA, valuesA, higherA);
+        maxB = L::blend(maxB, valuesB, higherB);
+        minAtA = _mm256_blendv_epi8(minAtA, indexA, lowerA);
+        minAtB = _mm256_blendv_epi8(minAtB, indexB, lowerB);
+        maxAtA = _mm256_blendv_epi8(maxAtA, indexA, higherA);
+        maxAtB = _mm256_blendv_epi8(maxAtB, indexB, higherB);
+    }
+    T mins[2 * lanes], maxs[2 * lanes];
+    typename L::Index minAt[2 * lanes], maxAt[2 * lanes];
+    L::store(mins, minA);
+    L::store(mins + lanes, minB);
+    L::store(maxs, maxA);
+    L::store(maxs + lanes, maxB);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(minAt), minAtA);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(minAt + lanes), minAtB);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(maxAt), maxAtA);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(maxAt + lanes), maxAtB);
+    return reduceLanes(data, count, i, mins, minAt, maxs, maxAt);
+}
+
+#endif // STL_SIMD_X86
+
+} // namespace minmax_detail
+
+// Min, max and their first positions in data[0, count), in one pass.
+// 'level' caps the instruction set used; the default is the best the CPU has.
+template <typename T>
+MinMaxResult<T> minMax(const T* data, std::size_t count, SimdLevel level = bestSimdLevel()) {
+#if defined(STL_SIMD_X86)
+    if constexpr (minmax_detail::hasKernels<T>) {
+        level = usableSimdLevel(level);
+        // 32-bit index lanes: longer ranges are done in blocks and the blocks merged.
+        constexpr std::size_t blockSize = std::size_t(1) << 31;
+        if (level != SimdLevel::Scalar && count >= 16) {
+            MinMaxResult<T> result;
+            for (std::size_t offset = 0; offset < count; offset += blockSize) {
+                std::size_t length = std::min(blockSize, count - offset);
+                MinMaxResult<T> block = length < 16 ? minmax_detail::minMaxScalar(data + offset, length)
+                                        : level == SimdLevel::Avx2 ? minmax_detail::minMaxAvx2(data + offset, length)
+                                                                   : minmax_detail::minMaxSse41(data + offset, length);
+                if (offset == 0 || block.min < result.min) {
+                    result.min = block.min;
+                    result.minIndex = block.minIndex + offset;
+                }
+                if (offset == 0 || result.max < block.max) {
+                    result.max = block.max;
+                    result.maxIndex = block.maxIndex + offset;
+                }
+            }
+            return result;
+        }
+    }
+#endif
+    (void)level;
+    return minmax_detail::minMaxScalar(data, count);
+}
+
+// Same, for any contiguous range (std::vector, std::array, a C array, ...).
+template <std::ranges::contiguous_range Range>
+auto minMax(const Range& range, SimdLevel level = bestSimdLevel()) {
+    return minMax(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), level);
+}
+
+#endif // MIN_MAX_H
@@ -0,0 +1,194 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_detail.h"
+
+/*
+ * MpmcQueue: a bounded, lock-free FIFO for any number of producer and consumer threads,
+ * where std::queue would need a std::mutex plus condition variables around every push
+ * and pop. For exactly one producer and one consumer SpscQueue (spsc_queue.h) is cheaper.
+ *
+ * The design is Dmitry Vyukov's bounded queue: a ring of a power-of-two number of slots,
+ * each with a sequence number next to the element. Slot i starts with sequence i. A push
+ * at position p may fill the slot once its sequence equals p and then sets it to p + 1; a
+ * pop at p may empty it once the sequence is p + 1 and then sets it to p + capacity, which
+ * is the position of the next push to that slot. Producers only contend on 'tail' and
+ * consumers only on 'head', each with one atomic operation per element; a producer and a
+ * consumer only meet on a slot, and only when the queue is nearly empty or full.
+ *
+ * Each slot takes a whole cache line, so threads working on neighbouring positions do not
+ * fight over a line (false sharing); that costs 64 bytes per slot for small elements.
+ *
+ * tryPush / tryPop never wait: they claim a position with a compare-and-swap only if its
+ * slot is ready, and return false when the queue is full / empty. push / pop take the
+ * next position unconditionally (fetch_add) and then wait for that slot, spinning briefly
+ * and yielding afterwards, like SpscQueue; a thread that waits holds its place in line, so
+ * waiting threads are served in order. A thread blocked in push / pop can only be woken by
+ * a matching pop / push: do not mix blocking calls with a shutdown that stops the other side.
+ *
+ * Once a position is taken its slot must be filled / emptied, so elements have to be nothrow
+ * movable; when the element's constructor from the emplace arguments may throw, the element
+ * is built before a position is taken and moved in.
+ *
+ * size() and empty() are snapshots. Elements left in the queue are destroyed with it.
+ */
+
+template <typename T>
+class MpmcQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                  "MpmcQueue: elements are moved in and out of claimed slots, which must not throw");
+
+public:
+    using value_type = T;
+
+    // Room for at least 'capacity' elements (rounded up to a power of two).
+    explicit MpmcQueue(std::size_t capacity)
+        : mask_(concurrency_detail::roundUpToPowerOfTwo(capacity < 1 ? 1 : capacity) - 1),
+          slots_(new Slot[mask_ + 1]) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            for (std::size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+                Slot& slot = slots_[pos & mask_];
+                if (slot.sequence.load(std::memory_order_relaxed) == pos + 1) {
+                    slot.element()->~T();
+                }
+            }
+        }
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    std::size_t size() const noexcept {
+        std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        // Waiting pops move head past tail; a stale head can put it far behind.
+        auto used = static_cast<std::ptrdiff_t>(tail - head);
+        if (used < 0) {
+            return 0;
+        }
+        return static_cast<std::size_t>(used) > capacity() ? capacity() : static_cast<std::size_t>(used);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // Constructs an element in place, false if the queue is full.
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+            // Built before a position is taken: a constructor throwing after that would leave a hole in the ring.
+            return tryEmplace(T(std::forward<Args>(args)...));
+        } else {
+            std::size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[pos & mask_];
+                auto lag = static_cast<std::ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - pos);
+                if (lag == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        fill(slot, pos, std::forward<Args>(args)...);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    // The slot still holds the element pushed one lap ago.
+                    return false;
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    bool tryPush(const T& value) { return tryEmplace(value); }
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    // Takes the next position and waits until its slot is free.
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+            emplace(T(std::forward<Args>(args)...));
+        } else {
+            std::size_t pos = tail_.fetch_add(1, std::memory_order_relaxed);
+            Slot& slot = slots_[pos & mask_];
+            concurrency_detail::waitUntil([&] { return slot.sequence.load(std::memory_order_acquire) == pos; });
+            fill(slot, pos, std::forward<Args>(args)...);
+        }
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    // Moves the oldest element into 'out', false if the queue is empty.
+    bool tryPop(T& out) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            auto lag = static_cast<std::ptrdiff_t>(slot.sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (lag == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = take(slot, pos);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Takes the next position and waits until its element has arrived.
+    T pop() {
+        std::size_t pos = head_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        concurrency_detail::waitUntil([&] { return slot.sequence.load(std::memory_order_acquire) == pos + 1; });
+        return take(slot, pos);
+    }
+
+private:
+    struct alignas(concurrency_detail::cacheLine) Slot {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* element() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    template <typename... Args>
+    void fill(Slot& slot, std::size_t pos, Args&&... args) {
+        ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    T take(Slot& slot, std::size_t pos) {
+        T* element = slot.element();
+        T value(std::move(*element));
+        element->~T();
+        slot.sequence.store(pos + capacity(), std::memory_order_release);
+        return value;
+    }
+
+    const std::size_t mask_;
+    const std::unique_ptr<Slot[]> slots_;
+
+    // Written by consumers.
+    alignas(concurrency_detail::cacheLine) std::atomic<std::size_t> head_{0};
+    // Written by producers.
+    alignas(concurrency_detail::cacheLine) std::atomic<std::size_t> tail_{0};
+};
+
+#endif // MPMC_QUEUE_H
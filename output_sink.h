@@ -0,0 +1,222 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+ * OutputSink: a buffered, flush-free replacement for std::cout.
+ *
+ * Everything streamed into the sink lands in one large reusable buffer.
+ * Numbers are formatted in place with std::to_chars, and the buffer only
+ * goes to the file descriptor (one write(2) call) when it is full, when
+ * flush() is called or when the sink is destroyed.
+ *
+ * A failing write (closed pipe, full disk, ...) puts the sink in a failed state, like
+ * the failbit of a stream: failed() and error() report it, and later output is dropped.
+ * Check failed() after a final flush() to know whether everything arrived.
+ *
+ * The print* templates in printers.h accept any output that supports <<,
+ * so they can target either std::cout or an OutputSink.
+ */
+
+template <typename T>
+concept SinkCharacter = std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>;
+
+template <typename T>
+concept SinkNumber = std::is_arithmetic_v<T> && !SinkCharacter<T> && !std::same_as<T, bool>;
+
+class OutputSink {
+public:
+    static constexpr std::size_t defaultCapacity = 1 << 16;
+
+    explicit OutputSink(int fd = 1, std::size_t capacity = defaultCapacity)
+        : fd_(fd), buffer_(capacity < 2 * maxNumberChars ? 2 * maxNumberChars : capacity) {}
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    ~OutputSink() {
+        flush();
+    }
+
+    void write(std::string_view text) {
+        if (text.size() > buffer_.size() - used_) {
+            flush();
+            // Too big to ever fit: hand it straight to the descriptor.
+            if (text.size() > buffer_.size()) {
+                writeAll(text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + used_, text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void put(char c) {
+        if (used_ == buffer_.size()) {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    // Integers and floating point values are formatted straight into the buffer.
+    // Floating point uses the same "%g, precision 6" format as std::cout.
+    template <SinkNumber T>
+    void writeNumber(T value) {
+        if (buffer_.size() - used_ < maxNumberChars) {
+            flush();
+        }
+        char* first = buffer_.data() + used_;
+        used_ = static_cast<std::size_t>(formatNumber(first, first + maxNumberChars, value) - buffer_.data());
+    }
+
+    // Bulk version for contiguous ranges: formats 'count' numbers, each followed by 'separator',
+    // checking the free space once per number instead of going through operator<< every time.
+    template <SinkNumber T>
+    void writeNumbers(const T* values, std::size_t count, char separator) {
+        char* cursor = buffer_.data() + used_;
+        char* limit = buffer_.data() + buffer_.size() - maxNumberChars - 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (cursor > limit) {
+                used_ = static_cast<std::size_t>(cursor - buffer_.data());
+                flush();
+                cursor = buffer_.data();
+            }
+            cursor = formatNumber(cursor, cursor + maxNumberChars, values[i]);
+            *cursor++ = separator;
+        }
+        used_ = static_cast<std::size_t>(cursor - buffer_.data());
+    }
+
+    void flush() {
+        if (used_ == 0) {
+            return;
+        }
+        // Keep the order right when std::cout and the sink share stdout.
+        if (fd_ == 1) {
+            std::cout.flush();
+        }
+        writeAll(buffer_.data(), used_);
+        used_ = 0;
+    }
+
+    // Bytes that reached the descriptor: buffered output counts once flush() has written it,
+    // output dropped after a failure never does.
+    std::size_t bytesWritten() const {
+        return written_;
+    }
+
+    // True once a write to the descriptor has failed; error() is its errno.
+    bool failed() const {
+        return error_ != 0;
+    }
+
+    int error() const {
+        return error_;
+    }
+
+private:
+    static constexpr std::size_t maxNumberChars = 64;
+
+    template <SinkNumber T>
+    static char* formatNumber(char* first, char* last, T value) {
+        if constexpr (std::is_floating_point_v<T>) {
+            return std::to_chars(first, last, value, std::chars_format::general, 6).ptr;
+        } else {
+            return std::to_chars(first, last, value).ptr;
+        }
+    }
+
+    void writeAll(const char* data, std::size_t size) {
+        while (size > 0 && error_ == 0) {
+#ifdef _WIN32
+            int n = ::_write(fd_, data, static_cast<unsigned>(size));
+#else
+            ssize_t n = ::write(fd_, data, size);
+#endif
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                error_ = errno;
+                return;
+            }
+            if (n == 0) {
+                // Nothing accepted and no error: retrying would loop forever.
+                error_ = EIO;
+                return;
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+            written_ += static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::size_t written_ = 0;
+    int error_ = 0;
+};
+
+inline OutputSink& operator<<(OutputSink& out, std::string_view text) {
+    out.write(text);
+    return out;
+}
+
+inline OutputSink& operator<<(OutputSink& out, const char* text) {
+    out.write(text);
+    return out;
+}
+
+inline OutputSink& operator<<(OutputSink& out, const std::string& text) {
+    out.write(text);
+    return out;
+}
+
+template <SinkCharacter T>
+OutputSink& operator<<(OutputSink& out, T c) {
+    out.put(static_cast<char>(c));
+    return out;
+}
+
+inline OutputSink& operator<<(OutputSink& out, bool value) {
+    out.put(value ? '1' : '0');
+    return out;
+}
+
+template <SinkNumber T>
+OutputSink& operator<<(OutputSink& out, T value) {
+    out.writeNumber(value);
+    return out;
+}
+
+// Anything else that knows how to print itself to a std::ostream still works,
+// it just takes the slow road through a temporary string stream.
+template <typename T>
+requires (!SinkNumber<T> && !SinkCharacter<T> && !std::convertible_to<const T&, std::string_view>
+          && requires(std::ostream& os, const T& value) { os << value; })
+OutputSink& operator<<(OutputSink& out, const T& value) {
+    std::ostringstream stream;
+    stream << value;
+    out.write(stream.view());
+    return out;
+}
+
+#endif // OUTPUT_SINK_H
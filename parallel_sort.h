@@ -0,0 +1,177 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.h"
+
+/*
+ * parallelSort: std::sort on every core, for std::vector, std::deque or any other
+ * random access range.
+ *
+ * It is a sample sort on the work-stealing ThreadPool from thread_pool.h:
+ *   1. sort a random sample and pick splitters from it, which cut the values into buckets
+ *      of roughly equal size (a few buckets per thread, so stealing can even out the rest);
+ *   2. in parallel, count how many elements of every block of the input fall in each bucket;
+ *   3. in parallel, move every element to its bucket's place in a buffer;
+ *   4. one task per bucket sorts it with std::sort and moves it back.
+ * Values equal to a splitter get a bucket of their own that needs no sorting, so inputs
+ * with many duplicates still split well. A bucket that still came out much too large
+ * is sample sorted again, as nested tasks.
+ *
+ * 'grainSize' is the smallest piece of work given to a task: ranges below two grains are
+ * sorted with std::sort directly, and blocks and buckets are never made smaller than one
+ * grain. Bigger grains mean less scheduling overhead, smaller ones better load balance.
+ *
+ * Like std::sort it is not stable. Element types must be default constructible (for the
+ * buffer); other types and pools with a single thread fall back to std::sort.
+ */
+
+inline constexpr std::size_t parallelSortGrain = std::size_t(1) << 14;
+
+namespace psort_detail {
+
+// Oversampling: this many sample elements per bucket.
+inline constexpr std::size_t samplesPerBucket = 16;
+
+template <typename T, typename Compare>
+class Buckets {
+public:
+    Buckets(std::vector<T> splitters, Compare& comp) : splitters_(std::move(splitters)), comp_(comp) {}
+
+    // Bucket 2i holds the values between splitter i - 1 and splitter i, bucket 2i + 1 the
+    // values equal to splitter i.
+    std::size_t count() const { return 2 * splitters_.size() + 1; }
+
+    std::size_t of(const T& value) const {
+        auto upper = std::upper_bound(splitters_.begin(), splitters_.end(), value, comp_);
+        auto index = static_cast<std::size_t>(upper - splitters_.begin());
+        if (index > 0 && !comp_(splitters_[index - 1], value)) {
+            return 2 * index - 1;
+        }
+        return 2 * index;
+    }
+
+    static bool needsSorting(std::size_t bucket) { return bucket % 2 == 0; }
+
+private:
+    std::vector<T> splitters_;
+    Compare& comp_;
+};
+
+template <typename It, typename Compare>
+void sampleSort(ThreadPool& pool, It first, It last, Compare& comp, std::size_t grain) {
+    using T = std::iter_value_t<It>;
+    auto n = static_cast<std::size_t>(last - first);
+    if (n < 2 * grain || pool.size() == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // 1. Splitters from a sorted random sample, without duplicates.
+    std::size_t bucketTarget = std::min(4 * pool.size(), n / grain);
+    std::vector<T> sample;
+    sample.reserve(bucketTarget * samplesPerBucket);
+    std::minstd_rand random(static_cast<unsigned>(n));
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    for (std::size_t i = 0; i < bucketTarget * samplesPerBucket; ++i) {
+        sample.push_back(first[static_cast<std::iter_difference_t<It>>(pick(random))]);
+    }
+    std::sort(sample.begin(), sample.end(), comp);
+    std::vector<T> splitters;
+    for (std::size_t i = 1; i < bucketTarget; ++i) {
+        const T& candidate = sample[i * samplesPerBucket];
+        if (splitters.empty() || comp(splitters.back(), candidate)) {
+            splitters.push_back(candidate);
+        }
+    }
+    Buckets<T, Compare> buckets(std::move(splitters), comp);
+    const std::size_t bucketCount = buckets.count();
+
+    // 2. Per-block bucket sizes.
+    std::size_t blockSize = std::max(grain, (n + 4 * pool.size() - 1) / (4 * pool.size()));
+    std::size_t blocks = (n + blockSize - 1) / blockSize;
+    std::vector<std::size_t> offsets(blocks * bucketCount, 0);
+    pool.parallelFor(blocks, [&](std::size_t block) {
+        std::size_t* counts = &offsets[block * bucketCount];
+        It begin = first + static_cast<std::iter_difference_t<It>>(block * blockSize);
+        It end = first + static_cast<std::iter_difference_t<It>>(std::min(n, (block + 1) * blockSize));
+        for (It it = begin; it != end; ++it) {
+            ++counts[buckets.of(*it)];
+        }
+    });
+
+    // Turn the counts into write positions: bucket by bucket, block by block inside a bucket.
+    std::vector<std::size_t> bucketStart(bucketCount + 1, 0);
+    std::size_t position = 0;
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        bucketStart[bucket] = position;
+        for (std::size_t block = 0; block < blocks; ++block) {
+            std::size_t size = offsets[block * bucketCount + bucket];
+            offsets[block * bucketCount + bucket] = position;
+            position += size;
+        }
+    }
+    bucketStart[bucketCount] = n;
+
+    // 3. Scatter into the buffer.
+    std::unique_ptr<T[]> buffer(new T[n]);
+    pool.parallelFor(blocks, [&](std::size_t block) {
+        std::size_t* next = &offsets[block * bucketCount];
+        It begin = first + static_cast<std::iter_difference_t<It>>(block * blockSize);
+        It end = first + static_cast<std::iter_difference_t<It>>(std::min(n, (block + 1) * blockSize));
+        for (It it = begin; it != end; ++it) {
+            buffer[next[buckets.of(*it)]++] = std::move(*it);
+        }
+    });
+
+    // 4. Sort the buckets and move them back.
+    std::size_t fairShare = n / ((bucketCount + 1) / 2);
+    TaskGroup group(pool);
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        std::size_t begin = bucketStart[bucket];
+        std::size_t size = bucketStart[bucket + 1] - begin;
+        if (size == 0) {
+            continue;
+        }
+        group.run([&, bucket, begin, size] {
+            T* data = buffer.get() + begin;
+            if (Buckets<T, Compare>::needsSorting(bucket)) {
+                if (size > 2 * fairShare) {
+                    sampleSort(pool, data, data + size, comp, grain);
+                } else {
+                    std::sort(data, data + size, comp);
+                }
+            }
+            std::move(data, data + size, first + static_cast<std::iter_difference_t<It>>(begin));
+        });
+    }
+    group.wait();
+}
+
+} // namespace psort_detail
+
+// Sorts [first, last) with 'comp' on 'pool'.
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void parallelSort(ThreadPool& pool, It first, It last, Compare comp = {}, std::size_t grainSize = parallelSortGrain) {
+    if constexpr (std::is_default_constructible_v<std::iter_value_t<It>>) {
+        psort_detail::sampleSort(pool, first, last, comp, std::max<std::size_t>(grainSize, 1));
+    } else {
+        std::sort(first, last, comp);
+    }
+}
+
+// Sorts [first, last) with 'comp' on defaultThreadPool().
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void parallelSort(It first, It last, Compare comp = {}, std::size_t grainSize = parallelSortGrain) {
+    parallelSort(defaultThreadPool(), first, last, comp, grainSize);
+}
+
+#endif // PARALLEL_SORT_H
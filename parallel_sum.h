@@ -0,0 +1,232 @@
+#ifndef PARALLEL_SUM_H
+#define PARALLEL_SUM_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.h"
+
+#if defined(STL_PARALLEL_STL)
+#include <execution>
+#endif
+
+/*
+ * safeSum / parallelSum: std::accumulate without the overflow, and on every core.
+ *
+ * std::accumulate(first, last, 0) adds in the type of the initial value, so summing a
+ * large vector<int> silently wraps around. Here the accumulator type comes from the
+ * element type (SumType<T>):
+ *   signed / unsigned integers up to 32 bits   long long / unsigned long long
+ *   64-bit integers                            __int128 / unsigned __int128 (GCC, Clang)
+ *   float, double                              double, with pairwise or Kahan summation
+ *   long double                                long double, same
+ * so integer sums are exact (up to 2^32 elements of 32-bit values) and floating point
+ * sums do not lose the small addends next to a large running total.
+ *
+ * parallelSum cuts the range into fixed chunks of sumChunkSize elements, sums every chunk
+ * in parallel and combines the chunk results in order, so the result does not depend on
+ * the number of threads. The chunks run under std::execution::par_unseq when the build
+ * has a parallel standard library backend (CMake defines STL_PARALLEL_STL when it finds
+ * TBB), and on defaultThreadPool() otherwise, or on the ThreadPool passed in.
+ */
+
+enum class Summation {
+    Pairwise,  // split in halves down to blocks of 128, add the blocks in a tree: O(log n) error growth
+    Kahan,     // running compensation for the lost low-order bits (Neumaier's variant)
+};
+
+inline constexpr std::size_t sumChunkSize = std::size_t(1) << 16;
+
+template <typename T>
+concept Summable = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+namespace sum_detail {
+
+template <typename T>
+struct SumTypeOf {
+    using type = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+};
+
+#if defined(__SIZEOF_INT128__)
+// __extension__: 128-bit integers are a GCC / Clang extension, this keeps -Wpedantic quiet.
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+
+template <typename T>
+requires(std::is_integral_v<T> && sizeof(T) == 8)
+struct SumTypeOf<T> {
+    using type = std::conditional_t<std::is_signed_v<T>, Int128, UInt128>;
+};
+#endif
+
+template <std::floating_point T>
+struct SumTypeOf<T> {
+    using type = std::conditional_t<std::is_same_v<T, long double>, long double, double>;
+};
+
+} // namespace sum_detail
+
+template <Summable T>
+using SumType = typename sum_detail::SumTypeOf<T>::type;
+
+namespace sum_detail {
+
+// A floating point sum with the error term carried next to it.
+template <typename F>
+struct Compensated {
+    F sum = 0;
+    F error = 0;
+
+    void add(F value) {
+        F total = sum + value;
+        // Neumaier: whichever operand is smaller lost its low bits.
+        if ((sum < 0 ? -sum : sum) >= (value < 0 ? -value : value)) {
+            error += (sum - total) + value;
+        } else {
+            error += (value - total) + sum;
+        }
+        sum = total;
+    }
+
+    F value() const { return sum + error; }
+};
+
+template <typename T>
+SumType<T> sumIntegers(const T* data, std::size_t count) {
+    // A plain loop over the wide type; compilers vectorize the widening adds.
+    SumType<T> total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        total += static_cast<SumType<T>>(data[i]);
+    }
+    return total;
+}
+
+template <typename T>
+SumType<T> sumPairwise(const T* data, std::size_t count) {
+    using F = SumType<T>;
+    if (count <= 128) {
+        // Eight independent partial sums: no long dependency chain, and the compiler can use SIMD.
+        F partial[8] = {};
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                partial[lane] += static_cast<F>(data[i + lane]);
+            }
+        }
+        F total = ((partial[0] + partial[1]) + (partial[2] + partial[3])) + ((partial[4] + partial[5]) + (partial[6] + partial[7]));
+        for (; i < count; ++i) {
+            total += static_cast<F>(data[i]);
+        }
+        return total;
+    }
+    std::size_t half = count / 2;
+    return sumPairwise(data, half) + sumPairwise(data + half, count - half);
+}
+
+template <typename T>
+Compensated<SumType<T>> sumKahan(const T* data, std::size_t count) {
+    Compensated<SumType<T>> total;
+    for (std::size_t i = 0; i < count; ++i) {
+        total.add(static_cast<SumType<T>>(data[i]));
+    }
+    return total;
+}
+
+// One chunk. Floating point chunks return their error term too, so the chunks can be combined without loss.
+template <typename T>
+auto sumChunk(const T* data, std::size_t count, Summation method) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (method == Summation::Kahan) {
+            return sumKahan(data, count);
+        }
+        return Compensated<SumType<T>>{sumPairwise(data, count), 0};
+    } else {
+        (void)method;
+        return sumIntegers(data, count);
+    }
+}
+
+// Runs sumChunk on every chunk with 'forEachChunk' and combines the results in chunk order.
+template <typename T, typename ForEachChunk>
+SumType<T> sumChunks(const T* data, std::size_t count, Summation method, ForEachChunk forEachChunk) {
+    std::size_t chunks = (count + sumChunkSize - 1) / sumChunkSize;
+    std::vector<decltype(sumChunk(data, 0, method))> partials(chunks);
+    forEachChunk(chunks, [&](std::size_t chunk) {
+        std::size_t begin = chunk * sumChunkSize;
+        partials[chunk] = sumChunk(data + begin, std::min(sumChunkSize, count - begin), method);
+    });
+    if constexpr (std::is_floating_point_v<T>) {
+        Compensated<SumType<T>> total;
+        for (const auto& partial : partials) {
+            total.add(partial.sum);
+            total.add(partial.error);
+        }
+        return total.value();
+    } else {
+        return std::accumulate(partials.begin(), partials.end(), SumType<T>(0));
+    }
+}
+
+} // namespace sum_detail
+
+// Overflow-safe sum of data[0, count) on the calling thread.
+template <Summable T>
+SumType<T> safeSum(const T* data, std::size_t count, Summation method = Summation::Pairwise) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (method == Summation::Kahan) {
+            return sum_detail::sumKahan(data, count).value();
+        }
+        return sum_detail::sumPairwise(data, count);
+    } else {
+        (void)method;
+        return sum_detail::sumIntegers(data, count);
+    }
+}
+
+// Same sum, computed on 'pool'.
+template <Summable T>
+SumType<T> parallelSum(ThreadPool& pool, const T* data, std::size_t count, Summation method = Summation::Pairwise) {
+    if (count <= sumChunkSize) {
+        return safeSum(data, count, method);
+    }
+    return sum_detail::sumChunks(data, count, method, [&](std::size_t chunks, auto&& body) {
+        pool.parallelFor(chunks, body);
+    });
+}
+
+// Same sum, computed under std::execution::par_unseq if available, else on defaultThreadPool().
+template <Summable T>
+SumType<T> parallelSum(const T* data, std::size_t count, Summation method = Summation::Pairwise) {
+    if (count <= sumChunkSize) {
+        return safeSum(data, count, method);
+    }
+#if defined(STL_PARALLEL_STL)
+    return sum_detail::sumChunks(data, count, method, [](std::size_t chunks, auto&& body) {
+        std::vector<std::size_t> indices(chunks);
+        std::iota(indices.begin(), indices.end(), std::size_t(0));
+        std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), body);
+    });
+#else
+    return parallelSum(defaultThreadPool(), data, count, method);
+#endif
+}
+
+template <std::ranges::contiguous_range Range>
+requires Summable<std::ranges::range_value_t<Range>>
+auto safeSum(const Range& range, Summation method = Summation::Pairwise) {
+    return safeSum(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), method);
+}
+
+template <std::ranges::contiguous_range Range>
+requires Summable<std::ranges::range_value_t<Range>>
+auto parallelSum(const Range& range, Summation method = Summation::Pairwise) {
+    return parallelSum(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), method);
+}
+
+#endif // PARALLEL_SUM_H
@@ -0,0 +1,174 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_sum.h"
+
+/*
+ * pipeline: lazy map / filter / reduce chains that run as one loop.
+ *
+ *     long long sumOfSmallSquares = pipeline(numbers)
+ *         .filter([](int x) { return x < 1000; })
+ *         .map([](int x) { return static_cast<long long>(x) * x; })
+ *         .sum();
+ *
+ * std::transform into the vector followed by std::accumulate reads the data, writes it
+ * back and reads it again; a transform into a temporary vector even allocates. Here map
+ * and filter only record a stage, and nothing runs until a terminal operation (reduce,
+ * sum, count, forEach, copyTo, toVector) walks the source once, pushing every element
+ * through all stages into the terminal.
+ *
+ * The stages are plain function objects composed at compile time (push style: each stage
+ * calls the next one), so after inlining the whole chain is a single loop over the source
+ * with no intermediate storage and no virtual calls. Contiguous sources are walked with
+ * plain pointers, and the loop is the one you would write by hand: the compiler vectorizes
+ * it whenever it would vectorize the hand-written loop (integer map + reduce chains; a
+ * filter when its condition can be turned into a blend). std::views::transform / filter
+ * are lazy too and fuse just as well; the pipeline adds the terminals, an overflow-safe
+ * sum() in particular, and stays a plain loop however many stages are chained.
+ *
+ * sum() adds types narrower than 64 bits in SumType<T> from parallel_sum.h (long long for
+ * int, double for float), so it does not overflow where std::accumulate(..., 0) would;
+ * 64-bit values are added as they are, which keeps the loop vectorizable (map to a wider
+ * type first if that can overflow). A pipeline refers to its source, which must outlive it.
+ */
+
+namespace pipeline_detail {
+
+// The first stage: elements go to the sink as they are.
+struct Source {
+    template <typename Sink>
+    Sink operator()(Sink sink) const {
+        return sink;
+    }
+};
+
+// A stage turns the sink for its output into a sink for its input.
+template <typename Previous, typename F>
+struct MapStage {
+    Previous previous;
+    F f;
+
+    template <typename Sink>
+    auto operator()(Sink sink) const {
+        return previous([f = f, sink](auto&& value) mutable {
+            sink(std::invoke(f, std::forward<decltype(value)>(value)));
+        });
+    }
+};
+
+template <typename Previous, typename Predicate>
+struct FilterStage {
+    Previous previous;
+    Predicate pred;
+
+    template <typename Sink>
+    auto operator()(Sink sink) const {
+        return previous([pred = pred, sink](auto&& value) mutable {
+            if (std::invoke(pred, std::as_const(value))) {
+                sink(std::forward<decltype(value)>(value));
+            }
+        });
+    }
+};
+
+} // namespace pipeline_detail
+
+template <typename It, typename Sentinel, typename Value, typename Stage = pipeline_detail::Source>
+class Pipeline {
+public:
+    using value_type = Value;
+
+    Pipeline(It first, Sentinel last, Stage stage = {}) : first_(first), last_(last), stage_(std::move(stage)) {}
+
+    // Lazily applies 'f' to every element.
+    template <typename F>
+    auto map(F f) const {
+        using Result = std::remove_cvref_t<std::invoke_result_t<F&, Value>>;
+        using Next = pipeline_detail::MapStage<Stage, F>;
+        return Pipeline<It, Sentinel, Result, Next>(first_, last_, Next{stage_, std::move(f)});
+    }
+
+    // Lazily drops the elements for which 'pred' is false.
+    template <typename Predicate>
+    auto filter(Predicate pred) const {
+        using Next = pipeline_detail::FilterStage<Stage, Predicate>;
+        return Pipeline<It, Sentinel, Value, Next>(first_, last_, Next{stage_, std::move(pred)});
+    }
+
+    // Calls 'f' on every element that comes out of the pipeline.
+    template <typename F>
+    void forEach(F f) const {
+        auto sink = stage_([&f](auto&& value) { std::invoke(f, std::forward<decltype(value)>(value)); });
+        for (It it = first_; it != last_; ++it) {
+            sink(*it);
+        }
+    }
+
+    // Left fold: op(...op(op(init, e0), e1)..., en).
+    template <typename T, typename Op>
+    T reduce(T init, Op op) const {
+        T total = std::move(init);
+        forEach([&total, &op](auto&& value) { total = std::invoke(op, std::move(total), std::forward<decltype(value)>(value)); });
+        return total;
+    }
+
+    // Sum of the elements: narrow arithmetic types are added in SumType<Value>, everything else in Value.
+    auto sum() const {
+        if constexpr (Summable<Value> && sizeof(Value) < sizeof(long long)) {
+            using Total = SumType<Value>;
+            return reduce(Total(0), [](Total total, Value value) { return total + static_cast<Total>(value); });
+        } else {
+            return reduce(Value{}, std::plus<>{});
+        }
+    }
+
+    std::size_t count() const {
+        return reduce(std::size_t(0), [](std::size_t n, const auto&) { return n + 1; });
+    }
+
+    // Writes the elements to 'out' and returns the end of the output.
+    template <typename Out>
+    Out copyTo(Out out) const {
+        forEach([&out](auto&& value) { *out++ = std::forward<decltype(value)>(value); });
+        return out;
+    }
+
+    std::vector<Value> toVector() const {
+        std::vector<Value> values;
+        copyTo(std::back_inserter(values));
+        return values;
+    }
+
+private:
+    It first_;
+    Sentinel last_;
+    Stage stage_;
+};
+
+// A pipeline over [first, last).
+template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+auto pipeline(It first, Sentinel last) {
+    return Pipeline<It, Sentinel, std::iter_value_t<It>>(first, last);
+}
+
+// A pipeline over a range; contiguous ranges are walked with plain pointers.
+template <std::ranges::input_range Range>
+requires std::ranges::borrowed_range<Range> || std::is_lvalue_reference_v<Range>
+auto pipeline(Range&& range) {
+    if constexpr (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>) {
+        auto* first = std::ranges::data(range);
+        return pipeline(first, first + std::ranges::size(range));
+    } else {
+        return pipeline(std::ranges::begin(range), std::ranges::end(range));
+    }
+}
+
+#endif // PIPELINE_H
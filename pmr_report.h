@@ -0,0 +1,210 @@
+#ifndef PMR_REPORT_H
+#define PMR_REPORT_H
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <forward_list>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "output_sink.h"
+
+/*
+ * std::pmr arena mode (run with --pmr-report [count]).
+ *
+ * Every container section of main.cpp is run three times with 'count' elements:
+ *   default    the std:: container on the global heap (one new/delete per node),
+ *   monotonic  the std::pmr:: container on a monotonic_buffer_resource (bump allocation,
+ *              nothing is freed until the resource goes away),
+ *   pool       the std::pmr:: container on an unsynchronized_pool_resource (size-class free lists).
+ *
+ * For each run we time building the container, one pass over it (how well the nodes
+ * are packed in memory) and the teardown (destroying the container and its resource).
+ * Stack, queue and priority_queue cannot be iterated, so they only get build and teardown.
+ * Each run is repeated arenaRuns times with a fresh container and resource, and every
+ * phase reports its fastest time, so a cold first run or a stray page fault does not
+ * decide the ranking.
+ */
+
+inline constexpr int arenaRuns = 5;
+
+enum class ArenaKind {
+    Default,
+    Monotonic,
+    Pool,
+};
+
+inline const char* arenaName(ArenaKind kind) {
+    switch (kind) {
+        case ArenaKind::Default: return "default";
+        case ArenaKind::Monotonic: return "monotonic";
+        case ArenaKind::Pool: return "pool";
+    }
+    return "";
+}
+
+struct ArenaRow {
+    std::string name;
+    ArenaKind kind;
+    double buildMs = 0;
+    double iterateMs = -1;  // < 0: container cannot be iterated
+    double teardownMs = 0;
+};
+
+// The same insert main() would do, for every kind of container.
+template <typename C>
+void arenaInsert(C& container, int i) {
+    if constexpr (requires { typename C::mapped_type; }) {
+        container.emplace("key" + std::to_string(i), i);
+    } else if constexpr (requires { typename C::key_type; }) {
+        container.insert(i);
+    } else if constexpr (requires { container.push(i); }) {
+        container.push(i);
+    } else if constexpr (requires { container.push_back(i); }) {
+        container.push_back(i);
+    } else {
+        container.push_front(i);
+    }
+}
+
+inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Builds, iterates and destroys one container. 'resource' is null for the default allocator.
+template <typename Container>
+ArenaRow timeArenaOnce(const std::string& name, ArenaKind kind, std::size_t count,
+                       std::unique_ptr<std::pmr::memory_resource> resource) {
+    ArenaRow row{name, kind};
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<Container> container;
+    if constexpr (std::is_constructible_v<Container, std::pmr::memory_resource*>) {
+        container = std::make_unique<Container>(resource.get());
+    } else {
+        container = std::make_unique<Container>();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        arenaInsert(*container, static_cast<int>(i));
+    }
+    row.buildMs = millisecondsSince(start);
+
+    if constexpr (requires { container->begin(); }) {
+        start = std::chrono::steady_clock::now();
+        long long sum = 0;
+        for (const auto& element : *container) {
+            if constexpr (requires { element.second; }) {
+                sum += element.second;
+            } else {
+                sum += element;
+            }
+        }
+        row.iterateMs = millisecondsSince(start);
+        // Keep the loop from being optimized away.
+        volatile long long keep = sum;
+        (void)keep;
+    }
+
+    start = std::chrono::steady_clock::now();
+    container.reset();
+    resource.reset();
+    row.teardownMs = millisecondsSince(start);
+    return row;
+}
+
+using ResourceFactory = std::unique_ptr<std::pmr::memory_resource> (*)();
+
+inline std::unique_ptr<std::pmr::memory_resource> noResource() {
+    return nullptr;
+}
+
+template <typename Resource>
+std::unique_ptr<std::pmr::memory_resource> newResource() {
+    return std::make_unique<Resource>();
+}
+
+// Best of arenaRuns runs of timeArenaOnce, phase by phase.
+template <typename Container>
+ArenaRow timeArena(const std::string& name, ArenaKind kind, std::size_t count, ResourceFactory makeResource) {
+    ArenaRow best = timeArenaOnce<Container>(name, kind, count, makeResource());
+    for (int run = 1; run < arenaRuns; ++run) {
+        ArenaRow row = timeArenaOnce<Container>(name, kind, count, makeResource());
+        best.buildMs = std::min(best.buildMs, row.buildMs);
+        best.iterateMs = std::min(best.iterateMs, row.iterateMs);
+        best.teardownMs = std::min(best.teardownMs, row.teardownMs);
+    }
+    return best;
+}
+
+// Runs one section with the default allocator and on both pmr resources.
+template <typename StdContainer, typename PmrContainer>
+void compareArenas(std::vector<ArenaRow>& rows, const std::string& name, std::size_t count) {
+    rows.push_back(timeArena<StdContainer>(name, ArenaKind::Default, count, noResource));
+    rows.push_back(timeArena<PmrContainer>(name, ArenaKind::Monotonic, count,
+                                           newResource<std::pmr::monotonic_buffer_resource>));
+    rows.push_back(timeArena<PmrContainer>(name, ArenaKind::Pool, count,
+                                           newResource<std::pmr::unsynchronized_pool_resource>));
+}
+
+inline void printArenaReport(OutputSink& out, const std::vector<ArenaRow>& rows) {
+    std::ostringstream table;
+    table << std::left << std::setw(44) << "Container" << std::setw(12) << "resource" << std::right
+          << std::setw(14) << "build ms" << std::setw(14) << "iterate ms" << std::setw(14) << "teardown ms" << '\n';
+    table << std::fixed << std::setprecision(3);
+    for (const ArenaRow& row : rows) {
+        table << std::left << std::setw(44) << row.name << std::setw(12) << arenaName(row.kind) << std::right
+              << std::setw(14) << row.buildMs;
+        if (row.iterateMs < 0) {
+            table << std::setw(14) << "-";
+        } else {
+            table << std::setw(14) << row.iterateMs;
+        }
+        table << std::setw(14) << row.teardownMs << '\n';
+    }
+    out << table.str();
+}
+
+inline void runArenaReport(OutputSink& out, std::size_t count) {
+    std::vector<ArenaRow> rows;
+
+    compareArenas<std::vector<int>, std::pmr::vector<int>>(rows, "std::vector<int>", count);
+    compareArenas<std::list<int>, std::pmr::list<int>>(rows, "std::list<int>", count);
+    compareArenas<std::deque<int>, std::pmr::deque<int>>(rows, "std::deque<int>", count);
+    compareArenas<std::set<int>, std::pmr::set<int>>(rows, "std::set<int>", count);
+    compareArenas<std::multiset<int>, std::pmr::multiset<int>>(rows, "std::multiset<int>", count);
+    compareArenas<std::map<std::string, int>, std::pmr::map<std::pmr::string, int>>(
+        rows, "std::map<std::string, int>", count);
+    compareArenas<std::multimap<std::string, int>, std::pmr::multimap<std::pmr::string, int>>(
+        rows, "std::multimap<std::string, int>", count);
+    compareArenas<std::stack<int>, std::stack<int, std::pmr::deque<int>>>(rows, "std::stack<int>", count);
+    compareArenas<std::queue<int>, std::queue<int, std::pmr::deque<int>>>(rows, "std::queue<int>", count);
+    compareArenas<std::priority_queue<int>, std::priority_queue<int, std::pmr::vector<int>>>(
+        rows, "std::priority_queue<int>", count);
+    compareArenas<std::forward_list<int>, std::pmr::forward_list<int>>(rows, "std::forward_list<int>", count);
+    compareArenas<std::unordered_set<int>, std::pmr::unordered_set<int>>(rows, "std::unordered_set<int>", count);
+    compareArenas<std::unordered_map<std::string, int>, std::pmr::unordered_map<std::pmr::string, int>>(
+        rows, "std::unordered_map<std::string, int>", count);
+    compareArenas<std::unordered_multimap<std::string, int>, std::pmr::unordered_multimap<std::pmr::string, int>>(
+        rows, "std::unordered_multimap<std::string, int>", count);
+    compareArenas<std::unordered_multiset<int>, std::pmr::unordered_multiset<int>>(
+        rows, "std::unordered_multiset<int>", count);
+
+    out << "Default heap vs std::pmr resources, " << count << " elements per container, best of " << arenaRuns
+        << " runs\n";
+    printArenaReport(out, rows);
+}
+
+#endif // PMR_REPORT_H
@@ -0,0 +1,245 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <forward_list>
+#include <list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/*
+ * PoolAllocator: a node allocator for std::list and std::forward_list.
+ *
+ * With std::allocator every list node is its own call to operator new: the nodes of one
+ * list end up scattered between everything else the program allocates, and after some
+ * inserts and erases a traversal is a chain of cache misses. PoolAllocator carves nodes
+ * out of 16 KiB slabs instead:
+ *
+ *  - allocate(1) pops the free list of the node's size class, or bumps a pointer in the
+ *    current slab, so nodes allocated one after another sit next to each other;
+ *  - deallocate(1) pushes the node onto its free list, to be reused by the next insert;
+ *  - the slabs are released in bulk when the last container (and allocator copy) using
+ *    the pool is destroyed. Released slabs go to a small cache per thread, so building
+ *    and destroying lists in a loop does not go back to the heap for every slab.
+ *
+ * A default-constructed PoolAllocator creates a new NodePool, so every pooled_list /
+ * pooled_forward_list gets its own pool by default. The pool has no lock: it belongs to
+ * the container, and a container is used by one thread at a time anyway. To let several
+ * containers share a pool (needed for splice and merge, which move nodes between them),
+ * construct them from the same allocator:
+ *
+ *     pooled_list<int> a;
+ *     pooled_list<int> b(a.get_allocator());   // same pool, a.splice(..., b) is fine
+ *
+ * Splicing between lists with different pools is undefined, as for any two allocators
+ * that compare unequal: the node would be freed into the wrong pool, or outlive its slab.
+ * Copying a container gives the copy a new pool; move construction and move assignment
+ * take the pool along with the nodes (the moved-from container keeps sharing it).
+ *
+ * Only single objects of at most poolMaxBlockBytes with ordinary alignment are pooled;
+ * arrays and anything larger go straight to operator new.
+ */
+
+inline constexpr std::size_t poolSlabBytes = 16 * 1024;
+inline constexpr std::size_t poolMaxBlockBytes = 256;
+inline constexpr std::size_t poolBlockAlignment = alignof(void*);
+// Free slabs each thread keeps for the next pool (1 MiB).
+inline constexpr std::size_t poolCachedSlabs = 64;
+
+namespace pool_detail {
+
+// Released slabs of this thread, handed to the next pool that needs one.
+struct SlabCache {
+    std::vector<void*> slabs;
+
+    ~SlabCache();
+};
+
+// Set once this thread's cache is gone; a pool destroyed later in thread (or program)
+// shutdown then frees its slabs directly. A plain bool needs no destructor, so it can be
+// read at any point.
+inline thread_local bool slabCacheDestroyed = false;
+
+inline SlabCache::~SlabCache() {
+    for (void* slab : slabs) {
+        ::operator delete(slab);
+    }
+    slabCacheDestroyed = true;
+}
+
+inline SlabCache& slabCache() {
+    thread_local SlabCache cache;
+    return cache;
+}
+
+inline void* takeSlab() {
+    if (!slabCacheDestroyed) {
+        SlabCache& cache = slabCache();
+        if (!cache.slabs.empty()) {
+            void* slab = cache.slabs.back();
+            cache.slabs.pop_back();
+            return slab;
+        }
+    }
+    return ::operator new(poolSlabBytes);
+}
+
+inline void giveBackSlab(void* slab) noexcept {
+    if (!slabCacheDestroyed) {
+        SlabCache& cache = slabCache();
+        if (cache.slabs.size() < poolCachedSlabs) {
+            try {
+                cache.slabs.push_back(slab);
+                return;
+            } catch (const std::bad_alloc&) {
+                // No room to cache it: free it below.
+            }
+        }
+    }
+    ::operator delete(slab);
+}
+
+constexpr std::size_t roundUpBlock(std::size_t bytes) {
+    return (bytes + poolBlockAlignment - 1) / poolBlockAlignment * poolBlockAlignment;
+}
+
+} // namespace pool_detail
+
+// Slab-backed free lists, one per block size (multiples of poolBlockAlignment up to
+// poolMaxBlockBytes). Not thread-safe.
+class NodePool {
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        for (void* slab : slabs_) {
+            pool_detail::giveBackSlab(slab);
+        }
+    }
+
+    // 'bytes' must be at most poolMaxBlockBytes.
+    void* allocate(std::size_t bytes) {
+        std::size_t block = pool_detail::roundUpBlock(bytes);
+        FreeBlock*& head = freeLists_[block / poolBlockAlignment - 1];
+        if (head != nullptr) {
+            FreeBlock* reused = head;
+            head = reused->next;
+            return reused;
+        }
+        if (static_cast<std::size_t>(limit_ - cursor_) < block) {
+            newSlab();
+        }
+        void* memory = cursor_;
+        cursor_ += block;
+        return memory;
+    }
+
+    // 'bytes' as passed to the allocate() that returned 'memory'.
+    void deallocate(void* memory, std::size_t bytes) noexcept {
+        std::size_t block = pool_detail::roundUpBlock(bytes);
+        FreeBlock*& head = freeLists_[block / poolBlockAlignment - 1];
+        head = ::new (memory) FreeBlock{head};
+    }
+
+    std::size_t slabCount() const noexcept {
+        return slabs_.size();
+    }
+
+    std::size_t reservedBytes() const noexcept {
+        return slabs_.size() * poolSlabBytes;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static_assert(poolBlockAlignment >= sizeof(FreeBlock) && poolBlockAlignment % alignof(FreeBlock) == 0);
+
+    void newSlab() {
+        slabs_.reserve(slabs_.size() + 1);
+        void* slab = pool_detail::takeSlab();
+        slabs_.push_back(slab);
+        // The tail of the previous slab (smaller than one block) is simply left unused.
+        cursor_ = static_cast<std::byte*>(slab);
+        limit_ = cursor_ + poolSlabBytes;
+    }
+
+    FreeBlock* freeLists_[poolMaxBlockBytes / poolBlockAlignment] = {};
+    std::byte* cursor_ = nullptr;
+    std::byte* limit_ = nullptr;
+    std::vector<void*> slabs_;
+};
+
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolAllocator() : pool_(std::make_shared<NodePool>()) {}
+
+    explicit PoolAllocator(std::shared_ptr<NodePool> pool) noexcept : pool_(std::move(pool)) {}
+
+    // No move constructor: a moved-from container keeps allocating, so its allocator must
+    // keep the pool (shared with the container it was moved into).
+    PoolAllocator(const PoolAllocator&) noexcept = default;
+    PoolAllocator& operator=(const PoolAllocator&) noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.sharedPool()) {}
+
+    T* allocate(std::size_t n) {
+        if (pooled(n)) {
+            return static_cast<T*>(pool_->allocate(sizeof(T)));
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* memory, std::size_t n) noexcept {
+        if (pooled(n)) {
+            pool_->deallocate(memory, sizeof(T));
+        } else {
+            std::allocator<T>().deallocate(memory, n);
+        }
+    }
+
+    // A copied container starts its own pool instead of sharing the original's.
+    PoolAllocator select_on_container_copy_construction() const {
+        return PoolAllocator();
+    }
+
+    NodePool& pool() const noexcept {
+        return *pool_;
+    }
+
+    const std::shared_ptr<NodePool>& sharedPool() const noexcept {
+        return pool_;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool_ == other.sharedPool();
+    }
+
+private:
+    static constexpr bool pooled(std::size_t n) noexcept {
+        return n == 1 && sizeof(T) <= poolMaxBlockBytes && alignof(T) <= poolBlockAlignment;
+    }
+
+    std::shared_ptr<NodePool> pool_;
+};
+
+template <typename T>
+using pooled_list = std::list<T, PoolAllocator<T>>;
+
+template <typename T>
+using pooled_forward_list = std::forward_list<T, PoolAllocator<T>>;
+
+#endif // POOL_ALLOCATOR_H
@@ -0,0 +1,126 @@
+#ifndef PRINTERS_H
+#define PRINTERS_H
+
+#include <charconv>
+#include <concepts>
+#include <iostream>
+#include <map>
+#include <ranges>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "output_sink.h"
+
+// Generic Programming or meta programming example, Very important for us
+// We let the compiler generate the appropriate container to print from.
+// The printers write to std::cout by default, or to any other output that supports <<
+// (e.g. an OutputSink, see output_sink.h).
+
+// Elements that look like std::pair (what map, multimap, unordered_map... hold).
+template <typename T>
+concept PairLike = requires(const T& element) {
+    element.first;
+    element.second;
+};
+
+// Contiguous storage of plain integers (vector<int>, array<long, N>, ...).
+// Characters and bool are left out, they print as text and not as numbers.
+template <typename C>
+concept ContiguousIntegers = std::ranges::contiguous_range<const C>
+                             && std::ranges::sized_range<const C>
+                             && std::integral<std::ranges::range_value_t<const C>>
+                             && SinkNumber<std::ranges::range_value_t<const C>>;
+
+// Formats a run of integers, each followed by a space, in chunks instead of one << per element.
+template <typename Out, typename T>
+void printIntegerRun(Out& out, const T* values, std::size_t count) {
+    if constexpr (std::same_as<Out, OutputSink>) {
+        out.writeNumbers(values, count, ' ');
+        return;
+    } else if constexpr (std::derived_from<Out, std::ostream>) {
+        // Respect std::hex, std::setw and friends: only take the fast road when the stream uses the defaults.
+        bool plainFormat = (out.flags() & std::ios_base::basefield) == std::ios_base::dec
+                           && !(out.flags() & std::ios_base::showpos) && out.width() == 0;
+        if (plainFormat) {
+            char buffer[4096];
+            std::size_t used = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (sizeof(buffer) - used < 32) {
+                    out.write(buffer, static_cast<std::streamsize>(used));
+                    used = 0;
+                }
+                used = static_cast<std::size_t>(std::to_chars(buffer + used, buffer + sizeof(buffer), values[i]).ptr - buffer);
+                buffer[used++] = ' ';
+            }
+            out.write(buffer, static_cast<std::streamsize>(used));
+            return;
+        }
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        out << values[i] << " ";
+    }
+}
+
+// One printer for every container. The element layout is checked at compile time:
+//  - contiguous integer ranges are formatted in bulk,
+//  - pair-like elements are printed as {key<pairSeparator>value},
+//  - everything else goes through operator<< one element at a time.
+template <std::ranges::input_range C, typename Out = std::ostream>
+void printContainer(const C& container, Out& out = std::cout, std::string_view prefix = "Printing: ",
+                    std::string_view pairSeparator = ": ") {
+    using Element = std::ranges::range_value_t<const C>;
+
+    out << prefix;
+    if constexpr (ContiguousIntegers<C>) {
+        printIntegerRun(out, std::ranges::data(container), std::ranges::size(container));
+    } else if constexpr (PairLike<Element>) {
+        for (const auto& el : container) {
+            out << "{" << el.first << pairSeparator << el.second << "} ";
+        }
+    } else {
+        for (auto it = std::ranges::begin(container); it != std::ranges::end(container); ++it) {
+            out << *it << " ";
+        }
+    }
+    out << '\n';
+}
+
+// The original printers, kept for the examples. They all use printContainer now.
+
+template <typename  T, typename Out = std::ostream>
+void printContainerForLoop(const T& container, Out& out = std::cout) {
+    printContainer(container, out);
+}
+
+template <typename Key, typename Value, typename Out = std::ostream>
+void printMap(const std::map<Key, Value>& container, Out& out = std::cout) {
+    printContainer(container, out);
+}
+
+template <typename Key, typename Value, typename Out = std::ostream>
+void printMapIterator(const std::map<Key, Value>& container, Out& out = std::cout) {
+    printContainer(container, out, "Map elements: ");
+}
+
+template <typename T, typename Out = std::ostream>
+void printContainerIterator(const T& container, Out& out = std::cout) {
+    printContainer(container, out);
+}
+
+template<typename KeyType, typename ValueType, typename Out = std::ostream>
+void printUnorderedMultimap(const std::unordered_multimap<KeyType, ValueType>& myUnorderedMultimap, Out& out = std::cout) {
+    printContainer(myUnorderedMultimap, out, "Unordered_multimap elements: ", ", ");
+}
+
+template<typename KeyType, typename ValueType, typename Out = std::ostream>
+void printUnorderedMap(const std::unordered_map<KeyType, ValueType>& myUnorderedMap, Out& out = std::cout) {
+    printContainer(myUnorderedMap, out, "Unordered_map elements: ", ", ");
+}
+
+template<typename KeyType, typename ValueType, typename Out = std::ostream>
+void printMultimap(const std::multimap<KeyType, ValueType>& myMultimap, Out& out = std::cout) {
+    printContainer(myMultimap, out, "Multimap elements: ", ", ");
+}
+
+#endif // PRINTERS_H
@@ -0,0 +1,346 @@
+#ifndef PRIORITY_HEAPS_H
+#define PRIORITY_HEAPS_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ * Priority queues for the cases std::priority_queue (a binary heap over a vector, with
+ * no way to change or remove an element once pushed) does not cover well.
+ *
+ * DaryHeap<T, Arity, Compare>    the same interface as std::priority_queue, on a heap with
+ *                                'Arity' (default 4) children per node. The tree is half
+ *                                as deep as a binary heap, and the 4 children of a node
+ *                                are next to each other in memory (one cache line for
+ *                                small T), so pop touches about half as many lines. Push
+ *                                compares fewer levels too; pop compares more per level.
+ * IndexedHeap<T, Compare>        a 4-ary heap of (priority, id) where id is a number the
+ *                                caller picks (e.g. a graph vertex). update(id, priority)
+ *                                raises or lowers a priority in place (decrease-key) and
+ *                                erase(id) removes any element, both O(log n), through a
+ *                                position table indexed by id.
+ * RadixHeap<Key, Value>          a min-queue for unsigned integer keys that never go below
+ *                                the last key popped (monotone: Dijkstra, event simulation
+ *                                with non-negative delays). Elements sit in buckets by the
+ *                                highest bit in which their key differs from the last
+ *                                minimum; push is O(1) and each element is moved between
+ *                                buckets at most once per bit of the key, with no
+ *                                comparisons between elements.
+ *
+ * Like std::priority_queue, DaryHeap and IndexedHeap put the *largest* element on top
+ * with the default std::less; use std::greater for a min-queue. top(), minKey() and pop()
+ * on an empty heap, and update() / erase() / priority() of an id that is not in the heap,
+ * are undefined. Pushing an id that is already in an IndexedHeap, or a key below the last
+ * minimum into a RadixHeap, throws std::invalid_argument.
+ */
+
+inline constexpr std::size_t defaultHeapArity = 4;
+
+namespace heap_detail {
+
+// Called with the new index of every element a sift moves (IndexedHeap tracks positions).
+inline constexpr auto noPlace = [](std::size_t) {};
+
+// Moves 'value' up from 'hole' until its parent is not lower priority; returns where it stopped.
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+std::size_t siftUp(std::vector<T>& heap, std::size_t hole, Compare& comp, const T& value, Place place) {
+    while (hole > 0) {
+        std::size_t parent = (hole - 1) / Arity;
+        if (!comp(heap[parent], value)) {
+            break;
+        }
+        heap[hole] = std::move(heap[parent]);
+        place(hole);
+        hole = parent;
+    }
+    return hole;
+}
+
+// Highest priority child of 'node', which has at least one child.
+template <std::size_t Arity, typename T, typename Compare>
+std::size_t bestChild(const std::vector<T>& heap, std::size_t node, Compare& comp) {
+    std::size_t first = Arity * node + 1;
+    std::size_t best = first;
+    if (first + Arity <= heap.size()) {
+        // Full set of children: a fixed trip count the compiler unrolls.
+        for (std::size_t i = 1; i < Arity; ++i) {
+            best = comp(heap[best], heap[first + i]) ? first + i : best;
+        }
+    } else {
+        for (std::size_t child = first + 1; child < heap.size(); ++child) {
+            best = comp(heap[best], heap[child]) ? child : best;
+        }
+    }
+    return best;
+}
+
+// Moves the hole at 'hole' down, pulling up the highest priority child while it beats
+// 'value'; returns where 'value' belongs.
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+std::size_t siftDown(std::vector<T>& heap, std::size_t hole, Compare& comp, const T& value, Place place) {
+    while (Arity * hole + 1 < heap.size()) {
+        std::size_t best = bestChild<Arity>(heap, hole, comp);
+        if (!comp(value, heap[best])) {
+            break;
+        }
+        heap[hole] = std::move(heap[best]);
+        place(hole);
+        hole = best;
+    }
+    return hole;
+}
+
+// For pop: the element taken from the back usually belongs near the bottom again, so the
+// hole at the root goes all the way down without comparing against 'value', which then
+// climbs back up the few levels it needs (Floyd's trick, as in libstdc++'s pop_heap).
+// About one comparison per level fewer than siftDown.
+template <std::size_t Arity, typename T, typename Compare, typename Place>
+std::size_t sinkToLeafAndSiftUp(std::vector<T>& heap, Compare& comp, const T& value, Place place) {
+    std::size_t hole = 0;
+    while (Arity * hole + 1 < heap.size()) {
+        std::size_t best = bestChild<Arity>(heap, hole, comp);
+        heap[hole] = std::move(heap[best]);
+        place(hole);
+        hole = best;
+    }
+    return siftUp<Arity>(heap, hole, comp, value, place);
+}
+
+} // namespace heap_detail
+
+template <typename T, std::size_t Arity = defaultHeapArity, typename Compare = std::less<T>>
+class DaryHeap {
+    static_assert(Arity >= 2, "DaryHeap: a node needs at least two children");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    DaryHeap() = default;
+    explicit DaryHeap(const Compare& comp) : comp_(comp) {}
+
+    // Builds the heap from a range in O(n).
+    template <std::input_iterator It>
+    DaryHeap(It first, It last, const Compare& comp = Compare()) : heap_(first, last), comp_(comp) {
+        if (heap_.size() < 2) {
+            return;
+        }
+        // From the last node with children back to the root.
+        for (std::size_t i = (heap_.size() - 2) / Arity + 1; i-- > 0;) {
+            T value = std::move(heap_[i]);
+            heap_[heap_detail::siftDown<Arity>(heap_, i, comp_, value, heap_detail::noPlace)] = std::move(value);
+        }
+    }
+
+    bool empty() const noexcept { return heap_.empty(); }
+    size_type size() const noexcept { return heap_.size(); }
+    const T& top() const { return heap_.front(); }
+
+    void reserve(size_type count) { heap_.reserve(count); }
+    void clear() noexcept { heap_.clear(); }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        heap_.emplace_back(std::forward<Args>(args)...);
+        T value = std::move(heap_.back());
+        heap_[heap_detail::siftUp<Arity>(heap_, heap_.size() - 1, comp_, value, heap_detail::noPlace)] = std::move(value);
+    }
+
+    void pop() {
+        T value = std::move(heap_.back());
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            heap_[heap_detail::sinkToLeafAndSiftUp<Arity>(heap_, comp_, value, heap_detail::noPlace)] = std::move(value);
+        }
+    }
+
+private:
+    std::vector<T> heap_;
+    [[no_unique_address]] Compare comp_;
+};
+
+template <typename T, typename Compare = std::less<T>>
+class IndexedHeap {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using Id = std::size_t;
+
+    IndexedHeap() = default;
+    // Ids below 'ids' need no growth of the position table.
+    explicit IndexedHeap(size_type ids, const Compare& comp = Compare()) : positions_(ids, npos), comp_{comp} {}
+
+    bool empty() const noexcept { return heap_.empty(); }
+    size_type size() const noexcept { return heap_.size(); }
+    const T& top() const { return heap_.front().priority; }
+    Id topId() const { return heap_.front().id; }
+
+    bool contains(Id id) const noexcept { return id < positions_.size() && positions_[id] != npos; }
+    const T& priority(Id id) const { return heap_[positions_[id]].priority; }
+
+    void push(Id id, T priority) {
+        if (id >= positions_.size()) {
+            positions_.resize(std::max(id + 1, positions_.size() * 2), npos);
+        } else if (positions_[id] != npos) {
+            throw std::invalid_argument("IndexedHeap::push: id is already in the heap");
+        }
+        heap_.push_back({std::move(priority), id});
+        Entry entry = std::move(heap_.back());
+        place(heap_detail::siftUp<arity>(heap_, heap_.size() - 1, comp_, entry, placer()), std::move(entry));
+    }
+
+    // Raises or lowers the priority of 'id' (decrease-key for a min-queue).
+    void update(Id id, T priority) {
+        std::size_t hole = positions_[id];
+        Entry entry{std::move(priority), id};
+        hole = heap_detail::siftUp<arity>(heap_, hole, comp_, entry, placer());
+        place(heap_detail::siftDown<arity>(heap_, hole, comp_, entry, placer()), std::move(entry));
+    }
+
+    void pop() {
+        positions_[heap_.front().id] = npos;
+        Entry last = std::move(heap_.back());
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            place(heap_detail::sinkToLeafAndSiftUp<arity>(heap_, comp_, last, placer()), std::move(last));
+        }
+    }
+
+    void erase(Id id) {
+        std::size_t hole = positions_[id];
+        positions_[id] = npos;
+        Entry last = std::move(heap_.back());
+        heap_.pop_back();
+        if (hole == heap_.size()) {
+            return;
+        }
+        hole = heap_detail::siftUp<arity>(heap_, hole, comp_, last, placer());
+        place(heap_detail::siftDown<arity>(heap_, hole, comp_, last, placer()), std::move(last));
+    }
+
+    void clear() noexcept {
+        for (const Entry& entry : heap_) {
+            positions_[entry.id] = npos;
+        }
+        heap_.clear();
+    }
+
+private:
+    static constexpr std::size_t arity = defaultHeapArity;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    // The priority is stored next to the id so sifting never looks anything up.
+    struct Entry {
+        T priority;
+        Id id;
+    };
+
+    struct EntryCompare {
+        [[no_unique_address]] Compare comp;
+        bool operator()(const Entry& a, const Entry& b) const { return comp(a.priority, b.priority); }
+    };
+
+    // Records the new position of the entry that was just moved into 'index'.
+    auto placer() {
+        return [this](std::size_t index) { positions_[heap_[index].id] = index; };
+    }
+
+    void place(std::size_t index, Entry&& entry) {
+        positions_[entry.id] = index;
+        heap_[index] = std::move(entry);
+    }
+
+    std::vector<Entry> heap_;
+    std::vector<std::size_t> positions_;
+    [[no_unique_address]] EntryCompare comp_;
+};
+
+template <std::unsigned_integral Key, typename Value>
+class RadixHeap {
+public:
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    // 'key' must not be below the last key popped (or returned by minKey).
+    void push(Key key, Value value) {
+        if (key < last_) {
+            throw std::invalid_argument("RadixHeap::push: key is below the last minimum");
+        }
+        buckets_[bucketOf(key)].emplace_back(key, std::move(value));
+        ++size_;
+    }
+
+    // The smallest key. Not const: it may move elements between buckets.
+    Key minKey() {
+        refill();
+        return buckets_[0].back().first;
+    }
+
+    // Removes and returns an element with the smallest key.
+    value_type pop() {
+        refill();
+        value_type top = std::move(buckets_[0].back());
+        buckets_[0].pop_back();
+        --size_;
+        return top;
+    }
+
+    void clear() noexcept {
+        for (auto& bucket : buckets_) {
+            bucket.clear();
+        }
+        size_ = 0;
+        last_ = 0;
+    }
+
+private:
+    static constexpr std::size_t bucketCount = std::numeric_limits<Key>::digits + 1;
+
+    // 0 for keys equal to the last minimum, else 1 + the highest bit that differs from it.
+    std::size_t bucketOf(Key key) const {
+        return key == last_ ? 0 : static_cast<std::size_t>(std::bit_width(static_cast<Key>(key ^ last_)));
+    }
+
+    // Makes bucket 0 hold the smallest keys: the first non-empty bucket is split by its
+    // minimum, and every element in it moves to a lower bucket.
+    void refill() {
+        if (!buckets_[0].empty()) {
+            return;
+        }
+        std::size_t index = 1;
+        while (buckets_[index].empty()) {
+            ++index;
+        }
+        std::vector<value_type>& bucket = buckets_[index];
+        Key smallest = bucket.front().first;
+        for (const value_type& element : bucket) {
+            smallest = element.first < smallest ? element.first : smallest;
+        }
+        last_ = smallest;
+        for (value_type& element : bucket) {
+            buckets_[bucketOf(element.first)].push_back(std::move(element));
+        }
+        bucket.clear();
+    }
+
+    std::vector<value_type> buckets_[bucketCount];
+    size_type size_ = 0;
+    Key last_ = 0;
+};
+
+#endif // PRIORITY_HEAPS_H
@@ -0,0 +1,156 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/*
+ * fastSort: a drop-in for std::sort that picks the algorithm at compile time.
+ *
+ * Integers and floating point values (or elements sorted by such a key, e.g. the
+ * .first of a pair, through a key extractor) are sorted with an LSD radix sort:
+ * one pass per byte of the key, each pass a counting scatter into a scratch buffer.
+ * That is O(n) and usually several times faster than std::sort for large inputs.
+ * Passes where every key has the same byte are skipped.
+ *
+ * Everything else, and ranges too short for the passes to pay off (radixSortThreshold
+ * elements per byte of key), go to std::sort (std::stable_sort when a key extractor is
+ * given, since the radix sort is stable too).
+ */
+
+// Minimum range length for the radix sort, per byte of key (1024 for int, 2048 for double).
+inline constexpr std::size_t radixSortThreshold = 256;
+
+// Keys the radix sort understands: integers (not bool) and IEEE float / double.
+template <typename K>
+concept RadixKey = (std::integral<K> && !std::same_as<K, bool>)
+                   || std::same_as<K, float> || std::same_as<K, double>;
+
+namespace radix_detail {
+
+template <typename K>
+using UnsignedKey = std::conditional_t<sizeof(K) == 1, std::uint8_t,
+                    std::conditional_t<sizeof(K) == 2, std::uint16_t,
+                    std::conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>>>;
+
+// Maps a key to an unsigned integer with the same ordering.
+template <RadixKey K>
+UnsignedKey<K> toUnsigned(K key) {
+    using U = UnsignedKey<K>;
+    constexpr U signBit = U(1) << (sizeof(K) * 8 - 1);
+    if constexpr (std::is_floating_point_v<K>) {
+        // Negative floats: flip every bit (bigger magnitude sorts lower). Positive: flip the sign bit.
+        U bits = std::bit_cast<U>(key);
+        return (bits & signBit) ? static_cast<U>(~bits) : static_cast<U>(bits | signBit);
+    } else if constexpr (std::is_signed_v<K>) {
+        return static_cast<U>(static_cast<U>(key) ^ signBit);
+    } else {
+        return static_cast<U>(key);
+    }
+}
+
+// Sorts data[0, n) by keyOf(element); 'scratch' must have room for n elements.
+template <typename T, typename KeyOf>
+void radixSortBuffers(T* data, T* scratch, std::size_t n, KeyOf keyOf) {
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyOf&, const T&>>;
+    constexpr std::size_t passes = sizeof(Key);
+
+    // One read of the input builds the histograms for every byte.
+    std::vector<std::array<std::size_t, 256>> counts(passes);
+    for (auto& count : counts) {
+        count.fill(0);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        auto key = toUnsigned(std::invoke(keyOf, data[i]));
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            ++counts[pass][(key >> (pass * 8)) & 0xff];
+        }
+    }
+
+    T* source = data;
+    T* target = scratch;
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        auto& count = counts[pass];
+        // All keys share this byte: the pass would not move anything.
+        if (count[(toUnsigned(std::invoke(keyOf, source[0])) >> (pass * 8)) & 0xff] == n) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (auto& bucket : count) {
+            std::size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t digit = (toUnsigned(std::invoke(keyOf, source[i])) >> (pass * 8)) & 0xff;
+            target[count[digit]++] = std::move(source[i]);
+        }
+        std::swap(source, target);
+    }
+    if (source != data) {
+        std::move(source, source + n, data);
+    }
+}
+
+} // namespace radix_detail
+
+// LSD radix sort of [first, last) by keyOf(element). Stable.
+template <std::random_access_iterator It, typename KeyOf = std::identity>
+requires RadixKey<std::remove_cvref_t<std::invoke_result_t<KeyOf&, const std::iter_value_t<It>&>>>
+void radixSort(It first, It last, KeyOf keyOf = {}) {
+    using T = std::iter_value_t<It>;
+    auto n = static_cast<std::size_t>(last - first);
+    if (n < 2) {
+        return;
+    }
+    if constexpr (std::contiguous_iterator<It>) {
+        std::unique_ptr<T[]> scratch(new T[n]);
+        radix_detail::radixSortBuffers(std::to_address(first), scratch.get(), n, keyOf);
+    } else {
+        // e.g. std::deque: sort a contiguous copy and move it back.
+        std::vector<T> values(std::make_move_iterator(first), std::make_move_iterator(last));
+        std::unique_ptr<T[]> scratch(new T[n]);
+        radix_detail::radixSortBuffers(values.data(), scratch.get(), n, keyOf);
+        std::move(values.begin(), values.end(), first);
+    }
+}
+
+// Ascending sort; radix sort for arithmetic elements, std::sort otherwise.
+template <std::random_access_iterator It>
+void fastSort(It first, It last) {
+    using T = std::iter_value_t<It>;
+    if constexpr (RadixKey<T>) {
+        if (static_cast<std::size_t>(last - first) >= radixSortThreshold * sizeof(T)) {
+            radixSort(first, last);
+            return;
+        }
+    }
+    std::sort(first, last);
+}
+
+// Stable ascending sort by keyOf(element); radix sort when the key is arithmetic.
+template <std::random_access_iterator It, typename KeyOf>
+void fastSort(It first, It last, KeyOf keyOf) {
+    using T = std::iter_value_t<It>;
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyOf&, const T&>>;
+    if constexpr (RadixKey<Key> && std::is_default_constructible_v<T>) {
+        if (static_cast<std::size_t>(last - first) >= radixSortThreshold * sizeof(Key)) {
+            radixSort(first, last, keyOf);
+            return;
+        }
+    }
+    std::stable_sort(first, last, [&](const T& a, const T& b) {
+        return std::invoke(keyOf, a) < std::invoke(keyOf, b);
+    });
+}
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,449 @@
+#ifndef RING_DEQUE_H
+#define RING_DEQUE_H
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * ring_deque<T>: a double-ended queue on a single ring buffer, as an alternative to
+ * std::deque, whose libstdc++ blocks are only 512 bytes (128 ints, 16 strings): a deque
+ * of a million ints is some 8000 separate allocations plus a block map, and every access
+ * goes through the map.
+ *
+ * The elements live in one buffer of a power-of-two capacity, starting at 'head' and
+ * wrapping around the end. push / pop at either end are O(1) (amortized: a full buffer
+ * doubles and the elements are moved once, in order, to the start of the new one), and
+ * element i is at buffer[(head + i) & (capacity - 1)], with no map lookup. The elements
+ * therefore form at most two contiguous runs: as_spans() returns them as two std::spans
+ * (the second empty when nothing wraps), for memcpy, SIMD kernels or the sorting and
+ * counting helpers in this repo.
+ *
+ * ring_deque<T, SegmentSize> is the segmented mode for very large deques, where doubling
+ * one buffer needs the old and the new buffer at once and moves every element. The ring
+ * is then split into segments of SegmentSize elements (a power of two) reached through a
+ * small table of pointers. Growing doubles the table and allocates new segments; the
+ * elements stay where they are, except for at most one segment's worth that wrapped
+ * around. Access costs one extra load (the segment pointer), and for_each_span() visits
+ * the contiguous runs, one per segment.
+ *
+ * Unlike std::deque: no insert / erase in the middle, and a push at either end that
+ * grows the buffer invalidates all iterators and references (std::deque keeps references
+ * valid). Iterators are random access.
+ */
+
+template <typename T, std::size_t SegmentSize = 0>
+class ring_deque {
+    static_assert(SegmentSize == 0 || std::has_single_bit(SegmentSize), "ring_deque: SegmentSize must be a power of two");
+
+    static constexpr bool segmented = SegmentSize > 0;
+
+    template <bool Const>
+    class basic_iterator;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    ring_deque() noexcept = default;
+
+    explicit ring_deque(size_type count) {
+        reserve(count);
+        while (size_ < count) {
+            emplace_back();
+        }
+    }
+
+    ring_deque(size_type count, const T& value) {
+        reserve(count);
+        while (size_ < count) {
+            push_back(value);
+        }
+    }
+
+    template <std::input_iterator InputIt>
+    ring_deque(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    ring_deque(std::initializer_list<T> values) : ring_deque(values.begin(), values.end()) {}
+
+    ring_deque(const ring_deque& other) : ring_deque(other.begin(), other.end()) {}
+
+    ring_deque(ring_deque&& other) noexcept { swap(other); }
+
+    ~ring_deque() {
+        clear();
+        freeStorage();
+    }
+
+    ring_deque& operator=(ring_deque other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(ring_deque& other) noexcept {
+        using std::swap;
+        swap(buffer_, other.buffer_);
+        swap(segments_, other.segments_);
+        swap(head_, other.head_);
+        swap(size_, other.size_);
+        swap(capacity_, other.capacity_);
+    }
+
+    friend void swap(ring_deque& a, ring_deque& b) noexcept { a.swap(b); }
+
+    // Element access
+
+    reference operator[](size_type index) { return slot(physical(index)); }
+    const_reference operator[](size_type index) const { return slot(physical(index)); }
+
+    reference at(size_type index) {
+        if (index >= size_) {
+            throw std::out_of_range("ring_deque::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= size_) {
+            throw std::out_of_range("ring_deque::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    reference front() { return slot(head_); }
+    const_reference front() const { return slot(head_); }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    // The elements in order as two contiguous runs; the second is empty unless they wrap.
+    std::pair<std::span<T>, std::span<T>> as_spans() noexcept requires(!segmented) {
+        size_type first = std::min(size_, capacity_ - head_);
+        return {std::span<T>(buffer_ + head_, first), std::span<T>(buffer_, size_ - first)};
+    }
+
+    std::pair<std::span<const T>, std::span<const T>> as_spans() const noexcept requires(!segmented) {
+        size_type first = std::min(size_, capacity_ - head_);
+        return {std::span<const T>(buffer_ + head_, first), std::span<const T>(buffer_, size_ - first)};
+    }
+
+    // Calls f(std::span) for each contiguous run of elements, in order.
+    template <typename F>
+    void for_each_span(F f) {
+        forEachRun(*this, f);
+    }
+
+    template <typename F>
+    void for_each_span(F f) const {
+        forEachRun(*this, f);
+    }
+
+    // Iterators
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // Capacity
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    void reserve(size_type count) {
+        if (count > capacity_) {
+            grow(std::bit_ceil(count));
+        }
+    }
+
+    // Modifiers
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < size_; ++i) {
+                slot(physical(i)).~T();
+            }
+        }
+        size_ = 0;
+        head_ = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Built first: 'args' may refer to an element that growing moves.
+            T value(std::forward<Args>(args)...);
+            grow(nextCapacity());
+            return *::new (static_cast<void*>(&slot(physical(size_++)))) T(std::move(value));
+        }
+        return *::new (static_cast<void*>(&slot(physical(size_++)))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        if (size_ == capacity_) {
+            T value(std::forward<Args>(args)...);
+            grow(nextCapacity());
+            return constructFront(std::move(value));
+        }
+        return constructFront(std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        --size_;
+        slot(physical(size_)).~T();
+    }
+
+    void pop_front() {
+        slot(head_).~T();
+        head_ = (head_ + 1) & (capacity_ - 1);
+        --size_;
+    }
+
+    friend bool operator==(const ring_deque& a, const ring_deque& b) {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+private:
+    static constexpr size_type minimumCapacity = segmented ? SegmentSize : 16;
+    static constexpr unsigned segmentShift = segmented ? std::countr_zero(SegmentSize) : 0;
+
+    size_type physical(size_type index) const noexcept { return (head_ + index) & (capacity_ - 1); }
+
+    T& slot(size_type position) const noexcept {
+        if constexpr (segmented) {
+            return segments_[position >> segmentShift][position & (SegmentSize - 1)];
+        } else {
+            return buffer_[position];
+        }
+    }
+
+    size_type nextCapacity() const noexcept { return capacity_ == 0 ? minimumCapacity : capacity_ * 2; }
+
+    template <typename... Args>
+    reference constructFront(Args&&... args) {
+        size_type position = (head_ - 1) & (capacity_ - 1);
+        T* element = ::new (static_cast<void*>(&slot(position))) T(std::forward<Args>(args)...);
+        head_ = position;
+        ++size_;
+        return *element;
+    }
+
+    template <typename Self, typename F>
+    static void forEachRun(Self& self, F& f) {
+        using Element = std::conditional_t<std::is_const_v<Self>, const T, T>;
+        size_type done = 0;
+        while (done < self.size_) {
+            size_type position = self.physical(done);
+            size_type runEnd = segmented ? (position | (SegmentSize - 1)) + 1 : self.capacity_;
+            size_type run = std::min(self.size_ - done, runEnd - position);
+            f(std::span<Element>(&self.slot(position), run));
+            done += run;
+        }
+    }
+
+    // 'capacity' is a power of two larger than capacity_.
+    void grow(size_type capacity) {
+        if constexpr (segmented) {
+            growSegments(std::max(capacity, minimumCapacity));
+        } else {
+            growBuffer(std::max(capacity, minimumCapacity));
+        }
+    }
+
+    // Moves the elements, in order, to the start of a new buffer.
+    void growBuffer(size_type capacity) {
+        T* buffer = std::allocator<T>().allocate(capacity);
+        size_type first = std::min(size_, capacity_ - head_);
+        try {
+            relocate(buffer_ + head_, first, buffer);
+            try {
+                relocate(buffer_, size_ - first, buffer + first);
+            } catch (...) {
+                std::destroy_n(buffer, first);
+                throw;
+            }
+        } catch (...) {
+            std::allocator<T>().deallocate(buffer, capacity);
+            throw;
+        }
+        std::destroy_n(buffer_ + head_, first);
+        std::destroy_n(buffer_, size_ - first);
+        freeStorage();
+        buffer_ = buffer;
+        capacity_ = capacity;
+        head_ = 0;
+    }
+
+    // Copies (or moves, when that cannot throw) 'count' elements into raw memory.
+    static void relocate(T* from, size_type count, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, count, to);
+        } else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    // Reorders the segment table so the segment holding 'head' comes first, then adds
+    // segments. Elements that had wrapped around into that same segment, in front of
+    // 'head', would now come first, so they move to the first new segment instead.
+    void growSegments(size_type capacity) {
+        size_type oldCount = segments_.size();
+        size_type newCount = capacity / SegmentSize;
+        std::vector<T*> segments;
+        segments.reserve(newCount);
+        size_type headSegment = head_ >> segmentShift;
+        size_type offset = head_ & (SegmentSize - 1);
+        for (size_type i = 0; i < oldCount; ++i) {
+            segments.push_back(segments_[(headSegment + i) % oldCount]);
+        }
+        try {
+            while (segments.size() < newCount) {
+                segments.push_back(std::allocator<T>().allocate(SegmentSize));
+            }
+        } catch (...) {
+            for (size_type i = oldCount; i < segments.size(); ++i) {
+                std::allocator<T>().deallocate(segments[i], SegmentSize);
+            }
+            throw;
+        }
+        // Slots [0, offset) of the head segment hold the last elements, if they are in use.
+        for (size_type i = 0; i < offset; ++i) {
+            size_type index = ((headSegment << segmentShift) + i - head_) & (capacity_ - 1);
+            if (index < size_) {
+                T& element = segments_[headSegment][i];
+                ::new (static_cast<void*>(segments[oldCount] + i)) T(std::move(element));
+                element.~T();
+            }
+        }
+        segments_ = std::move(segments);
+        capacity_ = capacity;
+        head_ = offset;
+    }
+
+    void freeStorage() noexcept {
+        if constexpr (segmented) {
+            for (T* segment : segments_) {
+                std::allocator<T>().deallocate(segment, SegmentSize);
+            }
+            segments_.clear();
+        } else if (buffer_ != nullptr) {
+            std::allocator<T>().deallocate(buffer_, capacity_);
+            buffer_ = nullptr;
+        }
+        capacity_ = 0;
+    }
+
+    template <bool Const>
+    class basic_iterator {
+        using Deque = std::conditional_t<Const, const ring_deque, ring_deque>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() noexcept = default;
+        basic_iterator(Deque* deque, size_type index) noexcept : deque_(deque), index_(index) {}
+
+        // iterator -> const_iterator
+        template <bool OtherConst>
+        requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept : deque_(other.deque_), index_(other.index_) {}
+
+        reference operator*() const noexcept { return (*deque_)[index_]; }
+        pointer operator->() const noexcept { return &(*deque_)[index_]; }
+        reference operator[](difference_type n) const noexcept { return (*deque_)[index_ + static_cast<size_type>(n)]; }
+
+        basic_iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+        basic_iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator copy = *this;
+            --index_;
+            return copy;
+        }
+        basic_iterator& operator+=(difference_type n) noexcept {
+            index_ += static_cast<size_type>(n);
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) noexcept {
+            index_ -= static_cast<size_type>(n);
+            return *this;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.index_ == b.index_; }
+        friend std::strong_ordering operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.index_ <=> b.index_;
+        }
+
+    private:
+        friend class basic_iterator<!Const>;
+
+        Deque* deque_ = nullptr;
+        size_type index_ = 0;
+    };
+
+    // Only one of the two is used, depending on the mode.
+    T* buffer_ = nullptr;
+    std::vector<T*> segments_;
+    size_type head_ = 0;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+};
+
+#endif // RING_DEQUE_H
@@ -0,0 +1,268 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Read-only search indexes over a sorted vector, for the case where the same data is
+ * searched millions of times.
+ *
+ * std::lower_bound on a large sorted vector jumps around memory: every step halves the
+ * range, so every step after the first few is a cache miss, and the next address is only
+ * known once the comparison is done (if the branch is mispredicted, the CPU even loads the
+ * wrong half first). These indexes copy the keys once into a layout where a search walks
+ * down a tree stored in one array:
+ *
+ * EytzingerIndex  the keys in BFS order of a binary search tree (like a binary heap):
+ *                 node k has its children at 2k and 2k + 1. The first levels share a few
+ *                 cache lines, the loop has no branch on the comparison result
+ *                 (k = 2k + (key < x)), and since the 16 descendants of k four levels down
+ *                 are next to each other, the search prefetches them while it works on k.
+ * BTreeIndex      an implicit B-tree ("S-tree"): nodes of one cache line of keys (16 ints),
+ *                 with node k's children at k * (B + 1) + 1 + i. A search reads one line
+ *                 per level, log_17(n) levels for ints instead of log_2(n), and compares a
+ *                 whole node at once (with SSE2 for ints).
+ *
+ * lowerBound(x) returns the position in the original sorted vector of the first key not
+ * less than x (its size if there is none), so it is a drop-in for
+ * std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin(); contains(x) is
+ * std::binary_search. Both indexes store every key plus a 32-bit position, so they hold
+ * at most 2^32 - 1 keys (std::length_error otherwise).
+ */
+
+namespace search_detail {
+
+inline constexpr std::size_t cacheLine = 64;
+
+// Allocates on cache line boundaries, so index arithmetic can tell where a line starts.
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(cacheLine)));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(cacheLine));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, CacheAlignedAllocator<T>>;
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+#if defined(__SSE2__)
+
+// How many of the 16 keys of a node are less than 'value': four compares, and the all-ones
+// lanes of the results summed up (each is -1) instead of a popcount.
+inline std::size_t countLessSse2(const int* keys, int value) {
+    __m128i x = _mm_set1_epi32(value);
+    __m128i sum = _mm_add_epi32(
+        _mm_add_epi32(_mm_cmpgt_epi32(x, _mm_load_si128(reinterpret_cast<const __m128i*>(keys))),
+                      _mm_cmpgt_epi32(x, _mm_load_si128(reinterpret_cast<const __m128i*>(keys + 4)))),
+        _mm_add_epi32(_mm_cmpgt_epi32(x, _mm_load_si128(reinterpret_cast<const __m128i*>(keys + 8))),
+                      _mm_cmpgt_epi32(x, _mm_load_si128(reinterpret_cast<const __m128i*>(keys + 12)))));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<std::size_t>(-_mm_cvtsi128_si32(sum));
+}
+
+#endif
+
+template <typename T, typename Compare>
+inline constexpr bool isPlainLess = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+inline void checkSize(std::size_t size) {
+    if (size >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("search index: too many keys");
+    }
+}
+
+} // namespace search_detail
+
+template <typename T, typename Compare = std::less<>>
+class EytzingerIndex {
+public:
+    // 'sorted' must be sorted by 'comp'.
+    explicit EytzingerIndex(std::span<const T> sorted, Compare comp = {})
+        : keys_(sorted.size() + 1), positions_(sorted.size() + 1), comp_(comp) {
+        search_detail::checkSize(sorted.size());
+        // Slot 0 is unused by the tree; a search that finds nothing ends there.
+        positions_[0] = static_cast<std::uint32_t>(sorted.size());
+        std::size_t next = 0;
+        build(sorted, 1, next);
+    }
+
+    explicit EytzingerIndex(const std::vector<T>& sorted, Compare comp = {})
+        : EytzingerIndex(std::span<const T>(sorted), comp) {}
+
+    std::size_t size() const noexcept { return keys_.size() - 1; }
+
+    std::size_t lowerBound(const T& value) const { return positions_[findSlot(value)]; }
+
+    bool contains(const T& value) const {
+        std::size_t slot = findSlot(value);
+        return slot != 0 && !comp_(value, keys_[slot]);
+    }
+
+private:
+    // Keys per cache line: the descendants of k this many levels down start at k * keysPerLine.
+    static constexpr std::size_t keysPerLine = std::max<std::size_t>(1, search_detail::cacheLine / sizeof(T));
+
+    // In-order walk of the implicit tree, handing out the sorted keys.
+    void build(std::span<const T> sorted, std::size_t k, std::size_t& next) {
+        if (k > sorted.size()) {
+            return;
+        }
+        build(sorted, 2 * k, next);
+        keys_[k] = sorted[next];
+        positions_[k] = static_cast<std::uint32_t>(next);
+        ++next;
+        build(sorted, 2 * k + 1, next);
+    }
+
+    std::size_t findSlot(const T& value) const {
+        const std::size_t n = size();
+        const T* keys = keys_.data();
+        const auto base = reinterpret_cast<std::uintptr_t>(keys);
+        std::size_t k = 1;
+        while (k <= n) {
+            // Integer arithmetic: the address may lie past the end, which a prefetch ignores.
+            search_detail::prefetch(reinterpret_cast<const void*>(base + k * keysPerLine * sizeof(T)));
+            k = 2 * k + static_cast<std::size_t>(comp_(keys[k], value));
+        }
+        // k went right (appended 1 bits) after the last key not less than 'value', then once left:
+        // drop those trailing ones and the zero before them to get back to that key.
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    search_detail::AlignedVector<T> keys_;
+    std::vector<std::uint32_t> positions_;
+    Compare comp_;
+};
+
+template <typename T, typename Compare = std::less<>>
+class BTreeIndex {
+public:
+    // 'sorted' must be sorted by 'comp'.
+    explicit BTreeIndex(std::span<const T> sorted, Compare comp = {}) : size_(sorted.size()), comp_(comp) {
+        search_detail::checkSize(sorted.size());
+        nodes_ = (size_ + keysPerNode - 1) / keysPerNode;
+        keys_.resize(nodes_ * keysPerNode);
+        positions_.resize(nodes_ * keysPerNode);
+        std::size_t next = 0;
+        build(sorted, 0, next);
+    }
+
+    explicit BTreeIndex(const std::vector<T>& sorted, Compare comp = {})
+        : BTreeIndex(std::span<const T>(sorted), comp) {}
+
+    std::size_t size() const noexcept { return size_; }
+
+    std::size_t lowerBound(const T& value) const {
+        std::size_t slot = findSlot(value);
+        return slot == noSlot ? size_ : positions_[slot];
+    }
+
+    bool contains(const T& value) const {
+        std::size_t slot = findSlot(value);
+        return slot != noSlot && !comp_(value, keys_[slot]);
+    }
+
+private:
+    static constexpr std::size_t keysPerNode = std::max<std::size_t>(1, search_detail::cacheLine / sizeof(T));
+    static constexpr std::size_t noSlot = std::numeric_limits<std::size_t>::max();
+
+    static std::size_t child(std::size_t node, std::size_t i) { return node * (keysPerNode + 1) + 1 + i; }
+
+    // In-order walk. The slots left over after the last key are filled with copies of it,
+    // which keeps every node sorted; they come after all real keys in order, so a search
+    // for a value not above the largest key always ends on a real key first.
+    void build(std::span<const T> sorted, std::size_t node, std::size_t& next) {
+        if (node >= nodes_) {
+            return;
+        }
+        for (std::size_t i = 0; i < keysPerNode; ++i) {
+            build(sorted, child(node, i), next);
+            std::size_t slot = node * keysPerNode + i;
+            if (next < sorted.size()) {
+                keys_[slot] = sorted[next];
+                positions_[slot] = static_cast<std::uint32_t>(next);
+                ++next;
+                largestSlot_ = slot;
+            } else {
+                keys_[slot] = sorted.back();
+                positions_[slot] = static_cast<std::uint32_t>(sorted.size());
+            }
+        }
+        build(sorted, child(node, keysPerNode), next);
+    }
+
+    std::size_t findSlot(const T& value) const {
+        if (size_ == 0 || comp_(keys_[largestSlot_], value)) {
+            return noSlot;
+        }
+        std::size_t found = noSlot;
+        std::size_t node = 0;
+        while (node < nodes_) {
+            std::size_t i = countLess(&keys_[node * keysPerNode], value);
+            // The deepest node with a key not less than 'value' has the closest one.
+            found = i < keysPerNode ? node * keysPerNode + i : found;
+            node = child(node, i);
+        }
+        return found;
+    }
+
+    std::size_t countLess(const T* keys, const T& value) const {
+#if defined(__SSE2__)
+        if constexpr (std::is_same_v<T, int> && search_detail::isPlainLess<T, Compare>) {
+            return search_detail::countLessSse2(keys, value);
+        }
+#endif
+        std::size_t less = 0;
+        for (std::size_t j = 0; j < keysPerNode; ++j) {
+            less += static_cast<std::size_t>(comp_(keys[j], value));
+        }
+        return less;
+    }
+
+    std::size_t size_;
+    std::size_t nodes_ = 0;
+    std::size_t largestSlot_ = 0;
+    search_detail::AlignedVector<T> keys_;
+    std::vector<std::uint32_t> positions_;
+    Compare comp_;
+};
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,63 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+/*
+ * Runtime CPU dispatch for the SIMD kernels (min_max.h and friends).
+ *
+ * The kernels are compiled for SSE4.1 and AVX2 with function-level target attributes,
+ * so the program itself still runs on any x86-64 CPU: bestSimdLevel() asks the CPU once
+ * which instruction sets it has, and each entry point picks its kernel from that.
+ * Passing a lower SimdLevel explicitly forces a slower path (used by the benchmarks).
+ *
+ * Target attributes are a GCC / Clang feature; other compilers and non-x86 targets
+ * only get the scalar code.
+ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STL_SIMD_X86 1
+#define STL_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define STL_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#include <immintrin.h>
+#endif
+
+enum class SimdLevel {
+    Scalar,
+    Sse41,
+    Avx2,
+};
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse41: return "sse4.1";
+        case SimdLevel::Avx2: return "avx2";
+    }
+    return "";
+}
+
+inline SimdLevel detectSimdLevel() {
+#if defined(STL_SIMD_X86)
+    __builtin_cpu_init();
+    // Every AVX2 CPU has POPCNT; the AVX2 kernels are allowed to use it.
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::Sse41;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+// The best level this CPU supports, detected on first use.
+inline SimdLevel bestSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+// 'requested', lowered to what the CPU (and compiler) can actually run.
+inline SimdLevel usableSimdLevel(SimdLevel requested) {
+    return static_cast<int>(requested) < static_cast<int>(bestSimdLevel()) ? requested : bestSimdLevel();
+}
+
+#endif // SIMD_DISPATCH_H
@@ -0,0 +1,398 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stack>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+ * small_vector<T, N>: a std::vector that keeps up to N elements inside the object itself
+ * and only allocates on the heap when it grows past N. Every demo container in main.cpp
+ * holds five elements, yet std::vector allocates for them and std::stack (a std::deque
+ * underneath, with its 512-byte block plus a block map) allocates twice; a small_vector
+ * with N >= 5 makes no allocation at all, and creating and destroying it is as cheap as
+ * a local array.
+ *
+ * Past N the elements move to a heap buffer that doubles as it grows, exactly like
+ * std::vector, and they stay there (shrink_to_fit moves them back inside when they fit).
+ * Iterators are plain pointers.
+ *
+ * Differences from std::vector to keep in mind:
+ *  - sizeof(small_vector<T, N>) is about N * sizeof(T) + 3 words: keep N small, and
+ *    prefer std::vector for members of large arrays of objects.
+ *  - Moving a small_vector whose elements are inline moves the elements one by one (the
+ *    buffer cannot be stolen), so iterators into a moved-from inline small_vector do not
+ *    carry over, and the move is O(N) rather than O(1).
+ *  - insert / erase / reallocation give the basic exception guarantee.
+ *
+ * small_stack<T, N> is std::stack over a small_vector: the same LIFO adaptor as in main.cpp,
+ * allocation free up to N elements.
+ */
+
+template <typename T, std::size_t N>
+class small_vector {
+    static_assert(N > 0, "small_vector: use std::vector when no elements are kept inline");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    small_vector() noexcept : data_(inlineData()) {}
+
+    explicit small_vector(size_type count) : small_vector() {
+        resize(count);
+    }
+
+    small_vector(size_type count, const T& value) : small_vector() {
+        assign(count, value);
+    }
+
+    template <std::input_iterator InputIt>
+    small_vector(InputIt first, InputIt last) : small_vector() {
+        assign(first, last);
+    }
+
+    small_vector(std::initializer_list<T> values) : small_vector(values.begin(), values.end()) {}
+
+    small_vector(const small_vector& other) : small_vector() {
+        reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), data_);
+        size_ = other.size_;
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector() {
+        takeFrom(other);
+    }
+
+    ~small_vector() {
+        std::destroy(begin(), end());
+        release();
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release();
+            data_ = inlineData();
+            capacity_ = N;
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    void assign(size_type count, const T& value) {
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(data_, count, value);
+        size_ = count;
+    }
+
+    template <std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        if constexpr (std::forward_iterator<InputIt>) {
+            auto count = static_cast<size_type>(std::distance(first, last));
+            reserve(count);
+            std::uninitialized_copy(first, last, data_);
+            size_ = count;
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    void assign(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    // Element access
+
+    reference operator[](size_type index) { return data_[index]; }
+    const_reference operator[](size_type index) const { return data_[index]; }
+
+    reference at(size_type index) {
+        if (index >= size_) {
+            throw std::out_of_range("small_vector::at: index out of range");
+        }
+        return data_[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= size_) {
+            throw std::out_of_range("small_vector::at: index out of range");
+        }
+        return data_[index];
+    }
+
+    reference front() { return data_[0]; }
+    const_reference front() const { return data_[0]; }
+    reference back() { return data_[size_ - 1]; }
+    const_reference back() const { return data_[size_ - 1]; }
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+
+    // Iterators
+
+    iterator begin() noexcept { return data_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // Capacity
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    size_type max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>()); }
+
+    // True while the elements live inside the object (no heap buffer).
+    bool is_inline() const noexcept { return data_ == inlineData(); }
+
+    void reserve(size_type count) {
+        if (count > capacity_) {
+            reallocate(count);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (!is_inline() && size_ < capacity_) {
+            reallocate(size_);
+        }
+    }
+
+    // Modifiers
+
+    void clear() noexcept {
+        std::destroy(begin(), end());
+        size_ = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Built first: 'args' may refer to an element that the reallocation moves.
+            T value(std::forward<Args>(args)...);
+            reallocate(grownCapacity(size_ + 1));
+            ::new (static_cast<void*>(data_ + size_)) T(std::move(value));
+        } else {
+            ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void pop_back() {
+        data_[--size_].~T();
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        auto index = static_cast<size_type>(position - begin());
+        if (index == size_) {
+            emplace_back(std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            emplace_back(std::move(back()));
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+            data_[index] = std::move(value);
+        }
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator position, const T& value) { return emplace(position, value); }
+    iterator insert(const_iterator position, T&& value) { return emplace(position, std::move(value)); }
+
+    iterator insert(const_iterator position, size_type count, const T& value) {
+        auto index = static_cast<size_type>(position - begin());
+        size_type oldSize = size_;
+        // Copied first: 'value' may be an element of this vector.
+        T copy(value);
+        reserve(size_ + count);
+        std::uninitialized_fill_n(end(), count, copy);
+        size_ += count;
+        std::rotate(begin() + index, begin() + oldSize, end());
+        return begin() + index;
+    }
+
+    // Appends the new elements and rotates them into place.
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator position, InputIt first, InputIt last) {
+        auto index = static_cast<size_type>(position - begin());
+        size_type oldSize = size_;
+        if constexpr (std::forward_iterator<InputIt>) {
+            reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+        std::rotate(begin() + index, begin() + oldSize, end());
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator position, std::initializer_list<T> values) {
+        return insert(position, values.begin(), values.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        iterator from = begin() + (first - cbegin());
+        iterator to = begin() + (last - cbegin());
+        if (from != to) {
+            iterator newEnd = std::move(to, end(), from);
+            std::destroy(newEnd, end());
+            size_ = static_cast<size_type>(newEnd - begin());
+        }
+        return from;
+    }
+
+    void resize(size_type count) {
+        resizeWith(count, [](T* place) { ::new (static_cast<void*>(place)) T(); });
+    }
+
+    void resize(size_type count, const T& value) {
+        if (count > size_ && count > capacity_) {
+            // 'value' may be an element.
+            T copy(value);
+            reserve(count);
+            resizeWith(count, [&](T* place) { ::new (static_cast<void*>(place)) T(copy); });
+        } else {
+            resizeWith(count, [&](T* place) { ::new (static_cast<void*>(place)) T(value); });
+        }
+    }
+
+    void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    T* inlineData() noexcept { return reinterpret_cast<T*>(buffer_); }
+    const T* inlineData() const noexcept { return reinterpret_cast<const T*>(buffer_); }
+
+    size_type grownCapacity(size_type needed) const {
+        return std::max(needed, capacity_ * 2);
+    }
+
+    // Moves the elements to a buffer for 'count' of them: the inline one when they fit
+    // (shrink_to_fit), a new heap buffer otherwise.
+    void reallocate(size_type count) {
+        bool toInline = count <= N;
+        T* target = toInline ? inlineData() : std::allocator<T>().allocate(count);
+        if (target == data_) {
+            return;
+        }
+        try {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                std::uninitialized_move(begin(), end(), target);
+            } else {
+                std::uninitialized_copy(begin(), end(), target);
+            }
+        } catch (...) {
+            if (!toInline) {
+                std::allocator<T>().deallocate(target, count);
+            }
+            throw;
+        }
+        std::destroy(begin(), end());
+        release();
+        data_ = target;
+        capacity_ = toInline ? N : count;
+    }
+
+    // Frees the heap buffer, if any; data_ and capacity_ are left for the caller to reset.
+    void release() noexcept {
+        if (!is_inline()) {
+            std::allocator<T>().deallocate(data_, capacity_);
+        }
+    }
+
+    // *this is empty and inline.
+    void takeFrom(small_vector& other) {
+        if (!other.is_inline()) {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.data_ = other.inlineData();
+            other.capacity_ = N;
+            other.size_ = 0;
+        } else {
+            std::uninitialized_move(other.begin(), other.end(), data_);
+            size_ = other.size_;
+            other.clear();
+        }
+    }
+
+    template <typename Construct>
+    void resizeWith(size_type count, Construct construct) {
+        if (count <= size_) {
+            std::destroy(begin() + count, end());
+            size_ = count;
+            return;
+        }
+        reserve(count);
+        for (; size_ < count; ++size_) {
+            construct(data_ + size_);
+        }
+    }
+
+    T* data_;
+    size_type size_ = 0;
+    size_type capacity_ = N;
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+};
+
+template <typename T, std::size_t N>
+using small_stack = std::stack<T, small_vector<T, N>>;
+
+#endif // SMALL_VECTOR_H
@@ -0,0 +1,600 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Binary snapshots for the containers used in main.cpp:
+ * std::vector, std::map, std::multimap, std::unordered_map and std::unordered_multimap.
+ *
+ * File layout (version 2, native byte order):
+ *
+ *   SnapshotHeader
+ *   key column     (the elements for a vector), starts on a 64 byte boundary
+ *   value column   (key-value containers only), starts on a 64 byte boundary
+ *
+ * A column of trivially copyable values is stored as a plain array.
+ * A column of std::string is stored as count + 1 uint64 offsets followed by the characters.
+ * Key-value containers are always written sorted by key (by the map's key_compare, and by
+ * std::less for the unordered containers), so a mapped file can be searched with a
+ * binary search without building a container first.
+ *
+ * The header records the byte order and its own size, so a file written on a platform
+ * with a different layout is rejected instead of read as garbage. Opening a file checks
+ * that every column lies inside it (and, for strings, that the offsets are in order),
+ * so a truncated or corrupt file throws SnapshotError instead of reading past the end.
+ *
+ * saveSnapshot() writes a file, loadSnapshot() rebuilds a container from it, and
+ * VectorSnapshotView / MapSnapshotView memory-map the file and read it in place (zero-copy).
+ */
+
+enum class SnapshotKind : std::uint32_t {
+    Vector = 1,
+    Map = 2,
+    Multimap = 3,
+    UnorderedMap = 4,
+    UnorderedMultimap = 5,
+};
+
+enum class ColumnType : std::uint32_t {
+    None = 0,
+    SignedInteger = 1,
+    UnsignedInteger = 2,
+    FloatingPoint = 3,
+    Bytes = 4,  // any other trivially copyable type
+    String = 5,
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t byteOrder;   // snapshotByteOrder, as the writing machine stores it
+    std::uint32_t headerSize;  // sizeof(SnapshotHeader) on the writing machine
+    std::uint32_t version;
+    SnapshotKind kind;
+    ColumnType keyType;
+    std::uint32_t keySize;
+    ColumnType valueType;
+    std::uint32_t valueSize;
+    std::uint64_t count;
+    std::uint64_t keyOffset;
+    std::uint64_t valueOffset;
+    std::uint64_t fileSize;
+};
+
+inline constexpr char snapshotMagic[8] = {'S', 'T', 'L', 'S', 'N', 'A', 'P', '\0'};
+inline constexpr std::uint32_t snapshotByteOrder = 0x01020304;
+inline constexpr std::uint32_t snapshotVersion = 2;
+inline constexpr std::uint64_t snapshotAlignment = 64;
+
+class SnapshotError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Which containers can be written, and what kind of snapshot they produce.
+template <typename C>
+struct SnapshotTraits;
+
+template <typename T, typename Alloc>
+struct SnapshotTraits<std::vector<T, Alloc>> {
+    static constexpr SnapshotKind kind = SnapshotKind::Vector;
+};
+
+template <typename K, typename V, typename Compare, typename Alloc>
+struct SnapshotTraits<std::map<K, V, Compare, Alloc>> {
+    static constexpr SnapshotKind kind = SnapshotKind::Map;
+};
+
+template <typename K, typename V, typename Compare, typename Alloc>
+struct SnapshotTraits<std::multimap<K, V, Compare, Alloc>> {
+    static constexpr SnapshotKind kind = SnapshotKind::Multimap;
+};
+
+template <typename K, typename V, typename Hash, typename Equal, typename Alloc>
+struct SnapshotTraits<std::unordered_map<K, V, Hash, Equal, Alloc>> {
+    static constexpr SnapshotKind kind = SnapshotKind::UnorderedMap;
+};
+
+template <typename K, typename V, typename Hash, typename Equal, typename Alloc>
+struct SnapshotTraits<std::unordered_multimap<K, V, Hash, Equal, Alloc>> {
+    static constexpr SnapshotKind kind = SnapshotKind::UnorderedMultimap;
+};
+
+template <typename C>
+concept Snapshottable = requires { SnapshotTraits<C>::kind; };
+
+// How one column of T is stored.
+template <typename T>
+struct ColumnTraits {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot columns hold trivially copyable types or std::string");
+
+    static constexpr ColumnType type = std::is_floating_point_v<T> ? ColumnType::FloatingPoint
+                                     : std::is_integral_v<T> && std::is_signed_v<T> ? ColumnType::SignedInteger
+                                     : std::is_integral_v<T> ? ColumnType::UnsignedInteger
+                                     : ColumnType::Bytes;
+    static constexpr std::uint32_t size = sizeof(T);
+    using view_type = const T&;
+};
+
+template <>
+struct ColumnTraits<std::string> {
+    static constexpr ColumnType type = ColumnType::String;
+    static constexpr std::uint32_t size = 0;
+    using view_type = std::string_view;
+};
+
+// A read-only column inside a mapped snapshot.
+template <typename T>
+class SnapshotColumn {
+public:
+    SnapshotColumn() = default;
+    SnapshotColumn(const std::byte* data, std::size_t count)
+        : values_(reinterpret_cast<const T*>(data), count) {}
+
+    const T& operator[](std::size_t index) const {
+        return values_[index];
+    }
+
+    std::span<const T> span() const {
+        return values_;
+    }
+
+private:
+    std::span<const T> values_;
+};
+
+template <>
+class SnapshotColumn<std::string> {
+public:
+    SnapshotColumn() = default;
+    SnapshotColumn(const std::byte* data, std::size_t count)
+        : offsets_(reinterpret_cast<const std::uint64_t*>(data), count + 1),
+          characters_(reinterpret_cast<const char*>(data + (count + 1) * sizeof(std::uint64_t))) {}
+
+    std::string_view operator[](std::size_t index) const {
+        return {characters_ + offsets_[index], offsets_[index + 1] - offsets_[index]};
+    }
+
+private:
+    std::span<const std::uint64_t> offsets_;
+    const char* characters_ = nullptr;
+};
+
+namespace snapshot_detail {
+
+inline std::uint64_t alignUp(std::uint64_t offset) {
+    return (offset + snapshotAlignment - 1) / snapshotAlignment * snapshotAlignment;
+}
+
+inline void pad(std::ofstream& file, std::uint64_t& offset) {
+    static constexpr char zeros[snapshotAlignment] = {};
+    std::uint64_t aligned = alignUp(offset);
+    file.write(zeros, static_cast<std::streamsize>(aligned - offset));
+    offset = aligned;
+}
+
+// Writes one column for 'items', using 'get' to pick the key or value out of each item.
+template <typename T, typename Items, typename Get>
+void writeColumn(std::ofstream& file, std::uint64_t& offset, const Items& items, Get get) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        std::vector<std::uint64_t> offsets;
+        offsets.reserve(items.size() + 1);
+        std::uint64_t total = 0;
+        offsets.push_back(0);
+        for (const auto& item : items) {
+            total += get(item).size();
+            offsets.push_back(total);
+        }
+        file.write(reinterpret_cast<const char*>(offsets.data()),
+                   static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+        for (const auto& item : items) {
+            const std::string& text = get(item);
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+        offset += offsets.size() * sizeof(std::uint64_t) + total;
+    } else {
+        for (const auto& item : items) {
+            const T& value = get(item);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        offset += items.size() * sizeof(T);
+    }
+}
+
+template <typename T>
+void checkColumn(ColumnType type, std::uint32_t size, const char* which) {
+    if (type != ColumnTraits<T>::type || size != ColumnTraits<T>::size) {
+        throw SnapshotError(std::string("snapshot ") + which + " column does not match the requested type");
+    }
+}
+
+inline bool isKeyValueKind(SnapshotKind kind) {
+    return kind != SnapshotKind::Vector;
+}
+
+} // namespace snapshot_detail
+
+// Writes 'container' to 'path', replacing the file.
+template <Snapshottable C>
+void saveSnapshot(const std::string& path, const C& container) {
+    using namespace snapshot_detail;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw SnapshotError("cannot open " + path + " for writing");
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.byteOrder = snapshotByteOrder;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.version = snapshotVersion;
+    header.kind = SnapshotTraits<C>::kind;
+    header.count = container.size();
+
+    // Reserve room for the header, it is rewritten once the offsets are known.
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::uint64_t offset = sizeof(header);
+
+    if constexpr (SnapshotTraits<C>::kind == SnapshotKind::Vector) {
+        using T = typename C::value_type;
+        header.keyType = ColumnTraits<T>::type;
+        header.keySize = ColumnTraits<T>::size;
+        pad(file, offset);
+        header.keyOffset = offset;
+        if constexpr (std::is_same_v<T, std::string>) {
+            writeColumn<T>(file, offset, container, [](const T& value) -> const T& { return value; });
+        } else {
+            file.write(reinterpret_cast<const char*>(container.data()),
+                       static_cast<std::streamsize>(container.size() * sizeof(T)));
+            offset += container.size() * sizeof(T);
+        }
+    } else {
+        using K = typename C::key_type;
+        using V = typename C::mapped_type;
+        using Entry = typename C::value_type;
+        header.keyType = ColumnTraits<K>::type;
+        header.keySize = ColumnTraits<K>::size;
+        header.valueType = ColumnTraits<V>::type;
+        header.valueSize = ColumnTraits<V>::size;
+
+        // Entries go out sorted by key (stable, so equal keys of a multimap keep their order).
+        std::vector<const Entry*> entries;
+        entries.reserve(container.size());
+        for (const auto& entry : container) {
+            entries.push_back(&entry);
+        }
+        // map and multimap keep their own order, the unordered containers get std::less.
+        auto order = [&] {
+            if constexpr (requires { container.key_comp(); }) {
+                return container.key_comp();
+            } else {
+                return std::less<K>{};
+            }
+        }();
+        auto byKey = [&](const Entry* a, const Entry* b) { return order(a->first, b->first); };
+        if (!std::is_sorted(entries.begin(), entries.end(), byKey)) {
+            std::stable_sort(entries.begin(), entries.end(), byKey);
+        }
+
+        pad(file, offset);
+        header.keyOffset = offset;
+        writeColumn<K>(file, offset, entries, [](const Entry* entry) -> const K& { return entry->first; });
+        pad(file, offset);
+        header.valueOffset = offset;
+        writeColumn<V>(file, offset, entries, [](const Entry* entry) -> const V& { return entry->second; });
+    }
+
+    header.fileSize = offset;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file) {
+        throw SnapshotError("failed writing " + path);
+    }
+}
+
+// A whole file mapped read-only into memory (read into a buffer where mmap is not available).
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw SnapshotError("cannot open " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = reinterpret_cast<const std::byte*>(buffer_.data());
+        size_ = buffer_.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SnapshotError("cannot open " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw SnapshotError("cannot stat " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw SnapshotError("cannot mmap " + path);
+            }
+            data_ = static_cast<const std::byte*>(mapping);
+        }
+        ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+#ifdef _WIN32
+        buffer_ = std::move(other.buffer_);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data_ != nullptr) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+#endif
+    }
+
+    const std::byte* data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    // Checks magic, byte order, version and sizes; returns the header.
+    const SnapshotHeader& header() const {
+        // Magic and byte order come first in every version, so they can be checked before
+        // the rest of the header is known to have this layout.
+        if (size_ < sizeof(snapshotMagic) + sizeof(std::uint32_t)) {
+            throw SnapshotError("file is too small to be a snapshot");
+        }
+        const auto& result = *reinterpret_cast<const SnapshotHeader*>(data_);
+        if (std::memcmp(result.magic, snapshotMagic, sizeof(result.magic)) != 0) {
+            throw SnapshotError("not a snapshot file");
+        }
+        if (result.byteOrder != snapshotByteOrder) {
+            throw SnapshotError("snapshot was written with a different byte order");
+        }
+        if (size_ < sizeof(SnapshotHeader)) {
+            throw SnapshotError("file is too small to be a snapshot");
+        }
+        if (result.headerSize != sizeof(SnapshotHeader)) {
+            throw SnapshotError("snapshot was written with a different header layout");
+        }
+        if (result.version != snapshotVersion) {
+            throw SnapshotError("unsupported snapshot version " + std::to_string(result.version));
+        }
+        if (result.fileSize != size_ || result.keyOffset > size_ || result.valueOffset > size_) {
+            throw SnapshotError("snapshot file is truncated or corrupt");
+        }
+        return result;
+    }
+
+    // The column of 'count' T at 'offset', after checking that all of it lies inside the
+    // file. For strings that includes the offset table and the characters it points to.
+    template <typename T>
+    SnapshotColumn<T> column(std::uint64_t offset, std::uint64_t count, const char* which) const {
+        auto corrupt = [which](const char* problem) {
+            return SnapshotError(std::string("snapshot ") + which + " column " + problem);
+        };
+        if (offset > size_ || offset % snapshotAlignment != 0) {
+            throw corrupt("has a bad offset");
+        }
+        std::uint64_t available = size_ - offset;
+        const std::byte* start = data_ + offset;
+        if constexpr (std::is_same_v<T, std::string>) {
+            // count + 1 offsets; written as a division so a huge count cannot overflow.
+            if (count >= available / sizeof(std::uint64_t)) {
+                throw corrupt("runs past the end of the file");
+            }
+            std::uint64_t offsetBytes = (count + 1) * sizeof(std::uint64_t);
+            const auto* offsets = reinterpret_cast<const std::uint64_t*>(start);
+            if (offsets[0] != 0) {
+                throw corrupt("has a bad first string offset");
+            }
+            for (std::uint64_t i = 1; i <= count; ++i) {
+                if (offsets[i] < offsets[i - 1]) {
+                    throw corrupt("has string offsets out of order");
+                }
+            }
+            if (offsets[count] > available - offsetBytes) {
+                throw corrupt("runs past the end of the file");
+            }
+        } else {
+            if (count > available / sizeof(T)) {
+                throw corrupt("runs past the end of the file");
+            }
+        }
+        return SnapshotColumn<T>(start, static_cast<std::size_t>(count));
+    }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#endif
+};
+
+// Zero-copy view of a vector snapshot.
+template <typename T>
+class VectorSnapshotView {
+public:
+    explicit VectorSnapshotView(const std::string& path) : file_(path) {
+        const SnapshotHeader& header = file_.header();
+        if (header.kind != SnapshotKind::Vector) {
+            throw SnapshotError("snapshot does not hold a vector");
+        }
+        snapshot_detail::checkColumn<T>(header.keyType, header.keySize, "element");
+        elements_ = file_.column<T>(header.keyOffset, header.count, "element");
+        count_ = static_cast<std::size_t>(header.count);
+    }
+
+    std::size_t size() const {
+        return count_;
+    }
+
+    typename ColumnTraits<T>::view_type operator[](std::size_t index) const {
+        return elements_[index];
+    }
+
+    // The elements as a span, for trivially copyable element types.
+    std::span<const T> span() const requires (!std::is_same_v<T, std::string>) {
+        return elements_.span();
+    }
+
+private:
+    MappedFile file_;
+    std::size_t count_ = 0;
+    SnapshotColumn<T> elements_;
+};
+
+// Zero-copy view of a map, multimap, unordered_map or unordered_multimap snapshot.
+// Entries are sorted by key, so lookups are binary searches over the mapped keys.
+// 'Compare' must be the order the file was written in (the saved map's key_compare) and
+// take key_view arguments; std::less<> fits std::less<K>, std::greater<> std::greater<K>.
+template <typename K, typename V, typename Compare = std::less<>>
+class MapSnapshotView {
+public:
+    using key_view = typename ColumnTraits<K>::view_type;
+    using value_view = typename ColumnTraits<V>::view_type;
+
+    explicit MapSnapshotView(const std::string& path, Compare compare = Compare()) : file_(path), compare_(compare) {
+        const SnapshotHeader& header = file_.header();
+        if (!snapshot_detail::isKeyValueKind(header.kind)) {
+            throw SnapshotError("snapshot does not hold a key-value container");
+        }
+        snapshot_detail::checkColumn<K>(header.keyType, header.keySize, "key");
+        snapshot_detail::checkColumn<V>(header.valueType, header.valueSize, "value");
+        kind_ = header.kind;
+        keys_ = file_.column<K>(header.keyOffset, header.count, "key");
+        values_ = file_.column<V>(header.valueOffset, header.count, "value");
+        count_ = static_cast<std::size_t>(header.count);
+    }
+
+    SnapshotKind kind() const {
+        return kind_;
+    }
+
+    std::size_t size() const {
+        return count_;
+    }
+
+    key_view key(std::size_t index) const {
+        return keys_[index];
+    }
+
+    value_view value(std::size_t index) const {
+        return values_[index];
+    }
+
+    // Index of the first entry whose key does not come before 'wanted'.
+    std::size_t lowerBound(key_view wanted) const {
+        std::size_t first = 0;
+        std::size_t length = count_;
+        while (length > 0) {
+            std::size_t half = length / 2;
+            if (compare_(keys_[first + half], wanted)) {
+                first += half + 1;
+                length -= half + 1;
+            } else {
+                length = half;
+            }
+        }
+        return first;
+    }
+
+    // The value stored for 'wanted' (the first one for multimaps), if any.
+    std::optional<std::remove_cvref_t<value_view>> find(key_view wanted) const {
+        std::size_t index = lowerBound(wanted);
+        if (index < count_ && !compare_(wanted, keys_[index])) {
+            return values_[index];
+        }
+        return std::nullopt;
+    }
+
+private:
+    MappedFile file_;
+    Compare compare_;
+    SnapshotKind kind_ = SnapshotKind::Map;
+    std::size_t count_ = 0;
+    SnapshotColumn<K> keys_;
+    SnapshotColumn<V> values_;
+};
+
+// Reads a snapshot back into a container. Any key-value snapshot can be loaded into any of
+// the key-value containers (duplicate keys are dropped when loading into map or unordered_map).
+template <Snapshottable C>
+C loadSnapshot(const std::string& path) {
+    C container;
+    if constexpr (SnapshotTraits<C>::kind == SnapshotKind::Vector) {
+        using T = typename C::value_type;
+        VectorSnapshotView<T> view(path);
+        if constexpr (std::is_same_v<T, std::string>) {
+            container.reserve(view.size());
+            for (std::size_t i = 0; i < view.size(); ++i) {
+                container.emplace_back(view[i]);
+            }
+        } else {
+            auto elements = view.span();
+            container.assign(elements.begin(), elements.end());
+        }
+    } else {
+        using K = typename C::key_type;
+        using V = typename C::mapped_type;
+        MapSnapshotView<K, V> view(path);
+        constexpr SnapshotKind kind = SnapshotTraits<C>::kind;
+        if constexpr (kind == SnapshotKind::UnorderedMap || kind == SnapshotKind::UnorderedMultimap) {
+            container.reserve(view.size());
+        }
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            if constexpr (kind == SnapshotKind::Map || kind == SnapshotKind::Multimap) {
+                // Sorted input: every entry goes right at the end.
+                container.emplace_hint(container.end(), K(view.key(i)), V(view.value(i)));
+            } else {
+                container.emplace(K(view.key(i)), V(view.value(i)));
+            }
+        }
+    }
+    return container;
+}
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,202 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_detail.h"
+
+/*
+ * SpscQueue: a bounded, lock-free FIFO for exactly one producer thread and one consumer
+ * thread, for handing data from one thread to another where the queue section of main.cpp
+ * uses std::queue (which is not thread-safe, and behind a mutex makes both threads wait
+ * on each other for every element).
+ *
+ * The elements live in a ring of a power-of-two number of slots, allocated once. The
+ * producer only writes 'tail', the consumer only writes 'head', so a push or a pop is a
+ * plain store plus one release store, with no read-modify-write instruction and no lock.
+ * The two indices sit on separate cache lines, away from the slots, so the threads do
+ * not invalidate each other's lines (false sharing) on every operation. Each side also
+ * keeps a private copy of the other side's index and only reloads the shared one when
+ * its copy says the ring is full (producer) or empty (consumer); in a steady stream most
+ * operations touch no line written by the other thread.
+ *
+ * pushBatch / popBatch move up to 'count' elements at once and publish them with a single
+ * index store, which amortizes the cache line transfer of the index over the batch.
+ *
+ * tryPush / tryPop never wait. push / pop wait until there is room / an element, spinning
+ * briefly and then yielding the CPU: use them when both threads have a core each, or the
+ * try variants with your own waiting strategy otherwise.
+ *
+ * Only the producer thread may call the push functions and only the consumer thread the
+ * pop functions. size() and empty() are snapshots and may be stale by the time they
+ * return. Elements left in the queue are destroyed with it.
+ */
+
+template <typename T>
+class SpscQueue {
+public:
+    using value_type = T;
+
+    // Room for at least 'capacity' elements (rounded up to a power of two).
+    explicit SpscQueue(std::size_t capacity)
+        : mask_(concurrency_detail::roundUpToPowerOfTwo(capacity < 1 ? 1 : capacity) - 1),
+          slots_(std::allocator<T>().allocate(mask_ + 1)) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            for (std::size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head) {
+                slots_[head & mask_].~T();
+            }
+        }
+        std::allocator<T>().deallocate(slots_, mask_ + 1);
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    std::size_t size() const noexcept {
+        std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        // A stale head can make tail - head look larger than the ring.
+        std::size_t used = tail - head;
+        return used > capacity() ? capacity() : used;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // Producer: constructs an element in place, false if the queue is full.
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity()) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity()) {
+                return false;
+            }
+        }
+        ::new (static_cast<void*>(slots_ + (tail & mask_))) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value) { return tryEmplace(value); }
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    // Producer: waits for room.
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        // Construct once, then retry the cheap move: 'args' may be consumed by the first attempt.
+        T value(std::forward<Args>(args)...);
+        concurrency_detail::waitUntil([&] { return tryEmplace(std::move(value)); });
+    }
+
+    void push(const T& value) {
+        concurrency_detail::waitUntil([&] { return tryEmplace(value); });
+    }
+
+    void push(T&& value) {
+        concurrency_detail::waitUntil([&] { return tryEmplace(std::move(value)); });
+    }
+
+    // Producer: copies up to 'count' elements from 'values' and publishes them together.
+    // Returns how many fitted.
+    std::size_t pushBatch(const T* values, std::size_t count) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (capacity() - (tail - cachedHead_) < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+        }
+        std::size_t room = capacity() - (tail - cachedHead_);
+        if (count > room) {
+            count = room;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(slots_ + ((tail + i) & mask_))) T(values[i]);
+        }
+        if (count > 0) {
+            tail_.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Consumer: moves the oldest element into 'out', false if the queue is empty.
+    bool tryPop(T& out) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        T& slot = slots_[head & mask_];
+        out = std::move(slot);
+        slot.~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: waits for an element.
+    T pop() {
+        concurrency_detail::waitUntil([&] { return !emptyForConsumer(); });
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        T& slot = slots_[head & mask_];
+        T value(std::move(slot));
+        slot.~T();
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Consumer: moves up to 'count' elements into 'out' and frees their slots together.
+    // Returns how many there were.
+    std::size_t popBatch(T* out, std::size_t count) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (cachedTail_ - head < count) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+        std::size_t available = cachedTail_ - head;
+        if (count > available) {
+            count = available;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            T& slot = slots_[(head + i) & mask_];
+            out[i] = std::move(slot);
+            slot.~T();
+        }
+        if (count > 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+private:
+    // Consumer side: refreshes the cached tail when it runs out.
+    bool emptyForConsumer() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+        return head == cachedTail_;
+    }
+
+    // Read-only after construction, shared by both threads.
+    alignas(concurrency_detail::cacheLine) const std::size_t mask_;
+    T* const slots_;
+
+    // Written by the consumer.
+    alignas(concurrency_detail::cacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t cachedTail_ = 0;
+
+    // Written by the producer.
+    alignas(concurrency_detail::cacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t cachedHead_ = 0;
+    // The alignment also rounds sizeof up, so whatever follows the queue starts on a new line.
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,247 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_sum.h"
+#include "simd_dispatch.h"
+#include "thread_pool.h"
+
+/*
+ * statistics: min, max, sum, the count of one value, mean and variance of a contiguous
+ * range in a single scan of memory, instead of min_element + max_element + count +
+ * accumulate + a second pass for the variance.
+ *
+ * The data is processed in chunks of statisticsChunkSize elements, small enough to stay
+ * in the L1 cache. For each chunk one loop collects min, max, sum and the count, and a
+ * second loop over the (now cached) chunk sums the squared differences from the chunk
+ * mean, which is numerically much safer than sum(x^2) - n * mean^2. The chunk results are
+ * merged with Chan et al.'s formula for combining variances. Both loops keep eight
+ * independent lanes, which the compiler turns into SIMD code; the SSE4.1 / AVX2 builds
+ * of the chunk kernel are picked at run time like the other kernels (simd_dispatch.h).
+ *
+ * parallelStatistics runs blocks of chunks on a ThreadPool and merges the block results
+ * in order, so the result does not depend on the number of threads.
+ *
+ * 'sum' is exact for integers (it is a SumType<T>, see parallel_sum.h); 'variance' is the
+ * population variance (divide by count); 'matches' counts the elements equal to the value
+ * passed in. An empty range gives count 0 and value-initialized fields. With NaNs in a
+ * float range the result is unspecified.
+ */
+
+inline constexpr std::size_t statisticsChunkSize = 2048;
+
+template <Summable T>
+struct Statistics {
+    std::size_t count = 0;
+    T min{};
+    T max{};
+    SumType<T> sum = 0;
+    std::size_t matches = 0;
+    double mean = 0;
+    double variance = 0;
+};
+
+namespace stats_detail {
+
+inline constexpr std::size_t lanes = 8;
+// Chunks per parallel task.
+inline constexpr std::size_t chunksPerBlock = 32;
+
+// Per lane sums: 64-bit for integers up to 32 bits (a chunk of them cannot overflow), SumType<T> otherwise.
+template <typename T>
+using LaneSum = std::conditional_t<std::is_integral_v<T> && sizeof(T) < 8,
+                                   std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>, SumType<T>>;
+
+// Statistics of a part of the range, with the sum of squared differences from its mean.
+template <typename T>
+struct Partial {
+    Statistics<T> stats;
+    double m2 = 0;
+};
+
+template <typename T>
+void merge(Partial<T>& into, const Partial<T>& part) {
+    if (part.stats.count == 0) {
+        return;
+    }
+    if (into.stats.count == 0) {
+        into = part;
+        return;
+    }
+    Statistics<T>& a = into.stats;
+    const Statistics<T>& b = part.stats;
+    auto n = static_cast<double>(a.count + b.count);
+    double delta = b.mean - a.mean;
+    into.m2 += part.m2 + delta * delta * static_cast<double>(a.count) * static_cast<double>(b.count) / n;
+    a.mean += delta * static_cast<double>(b.count) / n;
+    a.min = b.min < a.min ? b.min : a.min;
+    a.max = a.max < b.max ? b.max : a.max;
+    a.sum += b.sum;
+    a.matches += b.matches;
+    a.count += b.count;
+}
+
+// One chunk (count <= statisticsChunkSize), count > 0.
+template <typename T>
+[[gnu::always_inline]] inline Partial<T> chunkBody(const T* data, std::size_t count, T value) {
+    T mins[lanes];
+    T maxs[lanes];
+    LaneSum<T> sums[lanes] = {};
+    std::uint32_t matches[lanes] = {};
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        mins[lane] = data[0];
+        maxs[lane] = data[0];
+    }
+    std::size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            T x = data[i + lane];
+            mins[lane] = x < mins[lane] ? x : mins[lane];
+            maxs[lane] = maxs[lane] < x ? x : maxs[lane];
+            sums[lane] += static_cast<LaneSum<T>>(x);
+            matches[lane] += x == value;
+        }
+    }
+    Partial<T> part;
+    Statistics<T>& stats = part.stats;
+    stats.count = count;
+    stats.min = mins[0];
+    stats.max = maxs[0];
+    LaneSum<T> sum = 0;
+    std::size_t matched = 0;
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        stats.min = mins[lane] < stats.min ? mins[lane] : stats.min;
+        stats.max = stats.max < maxs[lane] ? maxs[lane] : stats.max;
+        sum += sums[lane];
+        matched += matches[lane];
+    }
+    for (; i < count; ++i) {
+        stats.min = data[i] < stats.min ? data[i] : stats.min;
+        stats.max = stats.max < data[i] ? data[i] : stats.max;
+        sum += static_cast<LaneSum<T>>(data[i]);
+        matched += data[i] == value;
+    }
+    stats.sum = static_cast<SumType<T>>(sum);
+    stats.matches = matched;
+    stats.mean = static_cast<double>(sum) / static_cast<double>(count);
+
+    // Second loop, over data that is still in L1.
+    double squares[lanes] = {};
+    i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            double d = static_cast<double>(data[i + lane]) - stats.mean;
+            squares[lane] += d * d;
+        }
+    }
+    for (; i < count; ++i) {
+        double d = static_cast<double>(data[i]) - stats.mean;
+        part.m2 += d * d;
+    }
+    for (double square : squares) {
+        part.m2 += square;
+    }
+    return part;
+}
+
+template <typename T>
+Partial<T> chunkScalar(const T* data, std::size_t count, T value) {
+    return chunkBody(data, count, value);
+}
+
+#if defined(STL_SIMD_X86)
+
+template <typename T>
+STL_TARGET_SSE41 Partial<T> chunkSse41(const T* data, std::size_t count, T value) {
+    return chunkBody(data, count, value);
+}
+
+template <typename T>
+STL_TARGET_AVX2 Partial<T> chunkAvx2(const T* data, std::size_t count, T value) {
+    return chunkBody(data, count, value);
+}
+
+#endif
+
+// Merged statistics of data[0, count), chunk by chunk.
+template <typename T>
+Partial<T> partialStatistics(const T* data, std::size_t count, T value, SimdLevel level) {
+    auto chunk = &chunkScalar<T>;
+#if defined(STL_SIMD_X86)
+    if (level == SimdLevel::Avx2) {
+        chunk = &chunkAvx2<T>;
+    } else if (level == SimdLevel::Sse41) {
+        chunk = &chunkSse41<T>;
+    }
+#endif
+    Partial<T> total;
+    for (std::size_t offset = 0; offset < count; offset += statisticsChunkSize) {
+        merge(total, chunk(data + offset, std::min(statisticsChunkSize, count - offset), value));
+    }
+    return total;
+}
+
+template <typename T>
+Statistics<T> finish(Partial<T> total) {
+    if (total.stats.count > 0) {
+        total.stats.variance = total.m2 / static_cast<double>(total.stats.count);
+    }
+    return total.stats;
+}
+
+} // namespace stats_detail
+
+// All statistics of data[0, count) in one scan; 'matches' counts the elements equal to 'value'.
+// 'level' caps the instruction set used; the default is the best the CPU has.
+template <Summable T>
+Statistics<T> statistics(const T* data, std::size_t count, T value, SimdLevel level = bestSimdLevel()) {
+    return stats_detail::finish(stats_detail::partialStatistics(data, count, value, usableSimdLevel(level)));
+}
+
+// Same, on 'pool'.
+template <Summable T>
+Statistics<T> parallelStatistics(ThreadPool& pool, const T* data, std::size_t count, T value,
+                                 SimdLevel level = bestSimdLevel()) {
+    constexpr std::size_t blockSize = statisticsChunkSize * stats_detail::chunksPerBlock;
+    level = usableSimdLevel(level);
+    if (count <= blockSize || pool.size() == 1) {
+        return statistics(data, count, value, level);
+    }
+    std::size_t blocks = (count + blockSize - 1) / blockSize;
+    std::vector<stats_detail::Partial<T>> partials(blocks);
+    pool.parallelFor(blocks, [&](std::size_t block) {
+        std::size_t offset = block * blockSize;
+        partials[block] = stats_detail::partialStatistics(data + offset, std::min(blockSize, count - offset), value, level);
+    });
+    stats_detail::Partial<T> total;
+    for (const auto& partial : partials) {
+        stats_detail::merge(total, partial);
+    }
+    return stats_detail::finish(total);
+}
+
+// Same, on defaultThreadPool().
+template <Summable T>
+Statistics<T> parallelStatistics(const T* data, std::size_t count, T value, SimdLevel level = bestSimdLevel()) {
+    return parallelStatistics(defaultThreadPool(), data, count, value, level);
+}
+
+template <std::ranges::contiguous_range Range>
+requires Summable<std::ranges::range_value_t<Range>>
+auto statistics(const Range& range, std::ranges::range_value_t<Range> value, SimdLevel level = bestSimdLevel()) {
+    return statistics(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), value, level);
+}
+
+template <std::ranges::contiguous_range Range>
+requires Summable<std::ranges::range_value_t<Range>>
+auto parallelStatistics(const Range& range, std::ranges::range_value_t<Range> value, SimdLevel level = bestSimdLevel()) {
+    return parallelStatistics(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)), value, level);
+}
+
+#endif // STATISTICS_H
@@ -0,0 +1,609 @@
+#ifndef SWISS_TABLE_H
+#define SWISS_TABLE_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * swiss_map and swiss_set: open-addressing hash tables in the style of Abseil's
+ * "Swiss tables", as an alternative to the node-per-entry std::unordered_map / set.
+ *
+ * Every slot has one control byte: empty, deleted, or (for a full slot) 7 bits of the
+ * key's hash. Slots are probed a group at a time (16 control bytes with SSE2, 32 with
+ * AVX2, compiled with -mavx2): one compare finds all slots in the group whose 7 hash
+ * bits match, so most lookups touch one group and compare one key, with no pointer chase.
+ *
+ * Groups are aligned, and a probe stops at the first group that still has an empty slot.
+ * That lets erase() mark a slot empty again, instead of leaving a tombstone, whenever
+ * its group has an empty slot. The table grows at a load factor of 7/8.
+ *
+ * Elements are std::pair<const Key, T> for swiss_map, so code written for
+ * std::unordered_map (it->first, it->second, printUnorderedMap-style loops) works as is.
+ * swiss_set only has const iterators, like std::unordered_set: an element is its own
+ * key, and changing it in place would leave it in the wrong slot.
+ * Unlike std::unordered_map, rehashing moves elements: iterators and references are
+ * invalidated by any insert that grows the table.
+ */
+
+namespace swiss_detail {
+
+using ctrl_t = std::int8_t;
+
+constexpr ctrl_t kEmpty = -128;   // 0b10000000
+constexpr ctrl_t kDeleted = -2;   // 0b11111110
+// Full slots hold the low 7 bits of the hash (0 .. 127), so "special" == sign bit set.
+
+// Spreads the bits of weak hashes (std::hash<int> is the identity) over the whole word.
+inline std::size_t mixHash(std::size_t hash) {
+    std::uint64_t h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+}
+
+#if defined(__AVX2__)
+
+struct Group {
+    static constexpr std::size_t width = 32;
+
+    explicit Group(const ctrl_t* ctrl) : bytes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctrl))) {}
+
+    std::uint32_t match(ctrl_t h2) const {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), bytes)));
+    }
+
+    std::uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(bytes));
+    }
+
+    __m256i bytes;
+};
+
+#elif defined(__SSE2__)
+
+struct Group {
+    static constexpr std::size_t width = 16;
+
+    explicit Group(const ctrl_t* ctrl) : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    std::uint32_t match(ctrl_t h2) const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes)));
+    }
+
+    std::uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes));
+    }
+
+    __m128i bytes;
+};
+
+#else
+
+// Portable fallback: same interface, one byte at a time.
+struct Group {
+    static constexpr std::size_t width = 16;
+
+    explicit Group(const ctrl_t* ctrl) {
+        std::memcpy(bytes, ctrl, width);
+    }
+
+    std::uint32_t match(ctrl_t h2) const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(bytes[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    std::uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(bytes[i] < 0) << i;
+        }
+        return mask;
+    }
+
+    ctrl_t bytes[width];
+};
+
+#endif
+
+struct Identity {
+    template <typename T>
+    const T& operator()(const T& value) const {
+        return value;
+    }
+};
+
+struct FirstOf {
+    template <typename Pair>
+    const auto& operator()(const Pair& pair) const {
+        return pair.first;
+    }
+};
+
+} // namespace swiss_detail
+
+// The open-addressing table shared by swiss_map and swiss_set.
+template <typename Key, typename Value, typename KeyOf, typename Hash, typename KeyEqual>
+class swiss_table {
+    using ctrl_t = swiss_detail::ctrl_t;
+    using Group = swiss_detail::Group;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const Value&, Value&>;
+        using pointer = std::conditional_t<Const, const Value*, Value*>;
+
+        basic_iterator() = default;
+
+        // A non-const iterator converts to a const one.
+        template <bool OtherConst>
+        requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other)
+            : ctrl_(other.ctrl_), end_(other.end_), slot_(other.slot_) {}
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        basic_iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skipToFull();
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.ctrl_ == b.ctrl_;
+        }
+
+    private:
+        friend class swiss_table;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(const ctrl_t* ctrl, const ctrl_t* end, Value* slot) : ctrl_(ctrl), end_(end), slot_(slot) {
+            skipToFull();
+        }
+
+        void skipToFull() {
+            while (ctrl_ != end_ && *ctrl_ < 0) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const ctrl_t* ctrl_ = nullptr;
+        const ctrl_t* end_ = nullptr;
+        Value* slot_ = nullptr;
+    };
+
+    // Elements that are their own key (swiss_set) must not be modified through an iterator.
+    using iterator = basic_iterator<std::is_same_v<Key, Value>>;
+    using const_iterator = basic_iterator<true>;
+
+    swiss_table() = default;
+
+    explicit swiss_table(size_type expected, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : hash_(hash), equal_(equal) {
+        reserve(expected);
+    }
+
+    swiss_table(std::initializer_list<value_type> values) {
+        reserve(values.size());
+        for (const auto& value : values) {
+            insert(value);
+        }
+    }
+
+    template <std::input_iterator InputIt>
+    swiss_table(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    swiss_table(const swiss_table& other) : hash_(other.hash_), equal_(other.equal_) {
+        reserve(other.size());
+        for (const auto& value : other) {
+            insert(value);
+        }
+    }
+
+    swiss_table(swiss_table&& other) noexcept
+        : ctrl_(std::exchange(other.ctrl_, nullptr)),
+          slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          growthLeft_(std::exchange(other.growthLeft_, 0)),
+          hash_(std::move(other.hash_)),
+          equal_(std::move(other.equal_)) {}
+
+    swiss_table& operator=(swiss_table other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~swiss_table() {
+        destroyAll();
+        deallocate(ctrl_, slots_, capacity_);
+    }
+
+    void swap(swiss_table& other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growthLeft_, other.growthLeft_);
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+    }
+
+    // Iterators
+
+    iterator begin() noexcept { return {ctrl_, ctrl_ + capacity_, slots_}; }
+    const_iterator begin() const noexcept { return {ctrl_, ctrl_ + capacity_, slots_}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return {ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_}; }
+    const_iterator end() const noexcept { return {ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_}; }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type bucket_count() const noexcept { return capacity_; }
+
+    float load_factor() const noexcept {
+        return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    static constexpr float max_load_factor() noexcept {
+        return 0.875f;
+    }
+
+    // Makes room for 'count' elements without growing again.
+    void reserve(size_type count) {
+        size_type capacity = Group::width;
+        while (maxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        if (capacity > capacity_) {
+            rehash(capacity);
+        }
+    }
+
+    // Modifiers
+
+    void clear() noexcept {
+        destroyAll();
+        if (capacity_ > 0) {
+            std::memset(ctrl_, swiss_detail::kEmpty, capacity_);
+        }
+        size_ = 0;
+        growthLeft_ = maxLoad(capacity_);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return emplaceWithKey(KeyOf{}(value), value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        const key_type& key = KeyOf{}(value);
+        return emplaceWithKey(key, std::move(value));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return insert(std::move(value));
+    }
+
+    size_type erase(const key_type& key) {
+        size_type index = findIndex(key, hashOf(key));
+        if (index == npos) {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+
+    iterator erase(const_iterator position) {
+        size_type index = static_cast<size_type>(position.ctrl_ - ctrl_);
+        eraseAt(index);
+        return {ctrl_ + index + 1, ctrl_ + capacity_, slots_ + index + 1};
+    }
+
+    // Lookup
+
+    iterator find(const key_type& key) {
+        size_type index = findIndex(key, hashOf(key));
+        return index == npos ? end() : iteratorAt(index);
+    }
+
+    const_iterator find(const key_type& key) const {
+        size_type index = findIndex(key, hashOf(key));
+        return index == npos ? end() : const_iterator(ctrl_ + index, ctrl_ + capacity_, slots_ + index);
+    }
+
+    bool contains(const key_type& key) const {
+        return findIndex(key, hashOf(key)) != npos;
+    }
+
+    size_type count(const key_type& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    hasher hash_function() const {
+        return hash_;
+    }
+
+    key_equal key_eq() const {
+        return equal_;
+    }
+
+protected:
+    static size_type maxLoad(size_type capacity) {
+        return capacity - capacity / 8;
+    }
+
+    size_type hashOf(const key_type& key) const {
+        return swiss_detail::mixHash(hash_(key));
+    }
+
+    static ctrl_t h2(size_type hash) {
+        return static_cast<ctrl_t>(hash & 0x7f);
+    }
+
+    iterator iteratorAt(size_type index) {
+        return {ctrl_ + index, ctrl_ + capacity_, slots_ + index};
+    }
+
+    // Probes whole groups: start at the group picked by the high hash bits and visit
+    // the others in triangular order, which covers every group of a power-of-two table.
+    size_type findIndex(const key_type& key, size_type hash) const {
+        if (capacity_ == 0) {
+            return npos;
+        }
+        size_type groupMask = capacity_ / Group::width - 1;
+        size_type group = (hash >> 7) & groupMask;
+        ctrl_t tag = h2(hash);
+        for (size_type step = 1;; ++step) {
+            size_type base = group * Group::width;
+            Group bytes(ctrl_ + base);
+            for (std::uint32_t mask = bytes.match(tag); mask != 0; mask &= mask - 1) {
+                size_type index = base + static_cast<size_type>(std::countr_zero(mask));
+                if (equal_(KeyOf{}(slots_[index]), key)) {
+                    return index;
+                }
+            }
+            if (bytes.matchEmpty() != 0) {
+                return npos;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of 'hash'.
+    size_type findFirstNonFull(size_type hash) const {
+        size_type groupMask = capacity_ / Group::width - 1;
+        size_type group = (hash >> 7) & groupMask;
+        for (size_type step = 1;; ++step) {
+            size_type base = group * Group::width;
+            std::uint32_t mask = Group(ctrl_ + base).matchEmptyOrDeleted();
+            if (mask != 0) {
+                return base + static_cast<size_type>(std::countr_zero(mask));
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // Finds 'key', or constructs a new element from 'args' in the slot where it belongs.
+    template <typename... Args>
+    std::pair<iterator, bool> emplaceWithKey(const key_type& key, Args&&... args) {
+        size_type hash = hashOf(key);
+        size_type index = findIndex(key, hash);
+        if (index != npos) {
+            return {iteratorAt(index), false};
+        }
+        index = prepareInsert(hash);
+        std::construct_at(slots_ + index, std::forward<Args>(args)...);
+        commitInsert(index, hash);
+        return {iteratorAt(index), true};
+    }
+
+    size_type prepareInsert(size_type hash) {
+        if (capacity_ == 0) {
+            rehash(Group::width);
+        }
+        size_type index = findFirstNonFull(hash);
+        // Reusing a deleted slot is free; taking an empty one needs growth budget.
+        if (growthLeft_ == 0 && ctrl_[index] == swiss_detail::kEmpty) {
+            // Mostly tombstones: clean up in place. Otherwise: grow.
+            rehash(size_ * 2 <= maxLoad(capacity_) ? capacity_ : capacity_ * 2);
+            index = findFirstNonFull(hash);
+        }
+        return index;
+    }
+
+    void commitInsert(size_type index, size_type hash) {
+        if (ctrl_[index] == swiss_detail::kEmpty) {
+            --growthLeft_;
+        }
+        ctrl_[index] = h2(hash);
+        ++size_;
+    }
+
+    void eraseAt(size_type index) {
+        std::destroy_at(slots_ + index);
+        --size_;
+        // A probe never runs past a group that has an empty slot, so if this group has
+        // one, nobody needs this slot as a stepping stone: make it empty, not deleted.
+        size_type base = index & ~(Group::width - 1);
+        if (Group(ctrl_ + base).matchEmpty() != 0) {
+            ctrl_[index] = swiss_detail::kEmpty;
+            ++growthLeft_;
+        } else {
+            ctrl_[index] = swiss_detail::kDeleted;
+        }
+    }
+
+    void rehash(size_type newCapacity) {
+        ctrl_t* oldCtrl = ctrl_;
+        value_type* oldSlots = slots_;
+        size_type oldCapacity = capacity_;
+
+        ctrl_ = new ctrl_t[newCapacity];
+        std::memset(ctrl_, swiss_detail::kEmpty, newCapacity);
+        slots_ = std::allocator<value_type>().allocate(newCapacity);
+        capacity_ = newCapacity;
+        growthLeft_ = maxLoad(newCapacity) - size_;
+
+        for (size_type i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] >= 0) {
+                size_type hash = hashOf(KeyOf{}(oldSlots[i]));
+                size_type index = findFirstNonFull(hash);
+                std::construct_at(slots_ + index, std::move(oldSlots[i]));
+                std::destroy_at(oldSlots + i);
+                ctrl_[index] = h2(hash);
+            }
+        }
+        deallocate(oldCtrl, oldSlots, oldCapacity);
+    }
+
+    void destroyAll() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] >= 0) {
+                    std::destroy_at(slots_ + i);
+                }
+            }
+        }
+    }
+
+    static void deallocate(ctrl_t* ctrl, value_type* slots, size_type capacity) noexcept {
+        delete[] ctrl;
+        if (slots != nullptr) {
+            std::allocator<value_type>().deallocate(slots, capacity);
+        }
+    }
+
+    ctrl_t* ctrl_ = nullptr;
+    value_type* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growthLeft_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+};
+
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using swiss_set = swiss_table<Key, Key, swiss_detail::Identity, Hash, KeyEqual>;
+
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class swiss_map : public swiss_table<Key, std::pair<const Key, T>, swiss_detail::FirstOf, Hash, KeyEqual> {
+    using Base = swiss_table<Key, std::pair<const Key, T>, swiss_detail::FirstOf, Hash, KeyEqual>;
+
+public:
+    using mapped_type = T;
+    using typename Base::iterator;
+    using Base::Base;
+    using Base::emplace;
+
+    // Only builds the mapped value when the key is not there yet.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return this->emplaceWithKey(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // The key is only moved from when it is inserted (it is looked up first).
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return this->emplaceWithKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // emplace(key, value...) only builds the element when the key is new. Other forms
+    // (std::piecewise_construct, a whole pair) go to the generic emplace.
+    template <typename K, typename... Args>
+    requires (sizeof...(Args) > 0 && !std::is_same_v<std::remove_cvref_t<K>, std::piecewise_construct_t> &&
+              std::is_constructible_v<Key, K &&>)
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<K>, Key>) {
+            return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        } else {
+            return try_emplace(Key(std::forward<K>(key)), std::forward<Args>(args)...);
+        }
+    }
+
+    T& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    T& at(const Key& key) {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("swiss_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("swiss_map::at: key not found");
+        }
+        return it->second;
+    }
+};
+
+#endif // SWISS_TABLE_H
@@ -0,0 +1,279 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * ThreadPool: a fixed set of worker threads for the parallel algorithms in this repo.
+ *
+ * Scheduling is work stealing: every worker has its own task deque. A task submitted
+ * from a worker goes to the back of that worker's deque and the worker takes its newest
+ * task first (good for recursive divide and conquer: the subproblem it just made is still
+ * in cache). An idle worker steals the oldest task from the front of another deque, which
+ * is usually the biggest piece of work left. Tasks submitted from outside the pool go
+ * to a shared deque that every worker steals from.
+ *
+ * TaskGroup runs tasks on a pool and waits for them. A waiting thread runs queued tasks,
+ * so tasks may start and wait for nested groups without deadlocking, and the caller of
+ * wait() adds its own thread to the pool. When nothing is queued it sleeps, like an idle
+ * worker, until either a new task is submitted (nested work it can help with) or the
+ * last task of its group finishes; it never spins.
+ *
+ * parallelFor(count, body) calls body(i) for every i in [0, count) and returns when all
+ * of them are done. The calling thread works too, so a pool of size N runs N bodies at
+ * once with N - 1 workers; a pool of size 1 simply runs the loop in the caller.
+ * Indices are handed out one at a time from a shared counter, so uneven work balances
+ * itself. The first exception thrown by a body or task is rethrown by the waiting thread.
+ */
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // 'threads' counts the caller: ThreadPool(4) starts 3 workers.
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : queues_(std::max<std::size_t>(threads, 1)) {
+        for (std::size_t i = 0; i + 1 < queues_.size(); ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Threads that run tasks, the caller included.
+    std::size_t size() const noexcept { return workers_.size() + 1; }
+
+    // Queues a task: on the current worker's deque, or on the shared one from outside the pool.
+    void submit(Task task) {
+        WorkQueue& queue = queues_[ownQueue()];
+        // Counted before it is visible, so a thief can never take the count below zero.
+        queued_.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            // Pairs with the predicate check in workerLoop, so the wakeup cannot be lost.
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    // Runs one queued task, own deque first, then stolen. False if there was nothing to run.
+    bool runPendingTask() {
+        Task task;
+        if (!popOwn(task) && !steal(task)) {
+            return false;
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    // Sleeps until a task is queued or done() holds. For threads waiting on a TaskGroup:
+    // they sleep with the idle workers, so submit() wakes them for new work too.
+    template <typename Done>
+    void waitForTaskOr(Done done) {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [&] { return queued_.load(std::memory_order_acquire) > 0 || done(); });
+    }
+
+    // Wakes every sleeping thread to re-check its condition; called when a TaskGroup finishes.
+    void wakeAll() {
+        {
+            // Pairs with the predicate check in waitForTaskOr, so the wakeup cannot be lost.
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_all();
+    }
+
+    template <typename Body>
+    void parallelFor(std::size_t count, Body&& body);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct Current {
+        const ThreadPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    // Which pool and queue the calling thread works for, if it is a worker.
+    static Current& current() {
+        static thread_local Current value;
+        return value;
+    }
+
+    // Workers own queues [0, size - 1); the last one is shared by all threads outside the pool.
+    std::size_t ownQueue() const {
+        return current().pool == this ? current().index : queues_.size() - 1;
+    }
+
+    bool popOwn(Task& task) {
+        WorkQueue& queue = queues_[ownQueue()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(Task& task) {
+        std::size_t own = ownQueue();
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkQueue& victim = queues_[(own + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(std::size_t index) {
+        current() = {this, index};
+        for (;;) {
+            if (runPendingTask()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<WorkQueue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> queued_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+// The pool shared by the parallel algorithms, one thread per hardware thread.
+inline ThreadPool& defaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// A set of tasks on a pool that can be waited for together.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = defaultThreadPool()) : pool_(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Tasks may still refer to the caller's stack: never leave before they are done.
+    ~TaskGroup() {
+        waitUntilDone();
+    }
+
+    template <typename F>
+    void run(F&& task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, &pool = pool_, task = std::forward<F>(task)]() mutable {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            // Once the count reaches zero the waiter may destroy the group: only the pool
+            // (which outlives it) is touched afterwards.
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pool.wakeAll();
+            }
+        });
+    }
+
+    // Runs queued tasks until every task of this group has finished.
+    void wait() {
+        waitUntilDone();
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            std::swap(error, error_);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void waitUntilDone() {
+        while (pending_.load(std::memory_order_acquire) > 0) {
+            if (!pool_.runPendingTask()) {
+                // The rest of the group is running on other threads: sleep until it is done
+                // or they queue more work.
+                pool_.waitForTaskOr([this] { return pending_.load(std::memory_order_acquire) == 0; });
+            }
+        }
+    }
+
+    ThreadPool& pool_;
+    std::atomic<std::size_t> pending_{0};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+template <typename Body>
+void ThreadPool::parallelFor(std::size_t count, Body&& body) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (std::size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+    std::atomic<std::size_t> next{0};
+    auto loop = [&] {
+        std::size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+            body(i);
+        }
+    };
+    TaskGroup group(*this);
+    for (std::size_t helper = 0; helper < std::min(workers_.size(), count - 1); ++helper) {
+        group.run(loop);
+    }
+    loop();
+    group.wait();
+}
+
+#endif // THREAD_POOL_H